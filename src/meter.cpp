@@ -29,659 +29,2642 @@
 */
 
 #include "meter.hpp"
+#include "meter_style_p.hpp"
+#include "meter_clock_p.hpp"
+#include "meter_window_p.hpp"
+#include "meter_history.hpp"
+#include "meter_stats.hpp"
+#include "meter_thresholds_p.hpp"
 
 // Qt include.
-#include <QMultiMap>
 #include <QPainter>
 #include <QtMath>
 #include <QVector>
-#include <QRadialGradient>
+#include <QPixmap>
+#include <QRegion>
+#include <QTimer>
+#include <QScreen>
+#include <QWindow>
+#include <QGuiApplication>
+#include <QEvent>
+#include <QElapsedTimer>
+#include <QPointer>
+
+// C++ include.
+#include <atomic>
+#include <deque>
+#include <limits>
+
+
+#if __cplusplus >= 201703L
+static_assert( std::atomic< qreal >::is_always_lock_free,
+	"Meter::postValue() requires lock-free atomic qreal." );
+static_assert( std::atomic< bool >::is_always_lock_free,
+	"Meter::postValue() requires lock-free atomic bool." );
+#endif
 
 
 //
 // MeterPrivate
 //
 
-class MeterPrivate {
+class MeterPrivate
+:  public MeterFrameClock::Client
+,  public MeterWindowWatcher::Client
+{
 public:
 	explicit MeterPrivate( Meter * parent )
-		:  drawValue( true )
-		,  drawGridValues( true )
-		,  valuePrecision( 0 )
-		,  scalePrecision( 0 )
+		:  perceptualFilter( false )
+		,  needleSprites( false )
+		,  coalescing( false )
+		,  valueDirty( false )
+		,  thresholdEntered( false )
+		,  updatePending( false )
+		,  thresholdsPending( false )
+		,  updateDepth( 0 )
+		,  animated( false )
+		,  animating( false )
+		,  animationTime( 300 )
+		,  animationDamping( 1.0 )
+		,  maxSlewRate( 0.0 )
+		,  needleValue( 0.0 )
+		,  needleVelocity( 0.0 )
+		,  statsInterval( 1000 )
+		,  obscured( true )
+		,  exposed( false )
+		,  catchUpPending( false )
+		,  extremesWindow( 0 )
+		,  trailTime( 0 )
+		,  trailHead( 0 )
+		,  trailHeadStart( 0.0 )
+		,  valueStatsHalfLife( 0 )
+		,  valueStatsWindow( 0 )
 		,  currentThreshold( 0 )
-		,  radius( 100 )
-		,  startScaleAngle( 30 )
-		,  stopScaleAngle( 330 )
-		,  minValue( 0.0 )
-		,  maxValue( 100.0 )
+		,  currentBand( -1 )
+		,  thresholdDwellTime( 0 )
+		,  needleAngleSteps( 720 )
+		,  frameRate( 0 )
 		,  value( 0.0 )
-		,  scaleStep( 1.0 )
-		,  scaleGridStep( 10.0 )
-		,  backgroundColor( Qt::black )
-		,  needleColor( Qt::blue )
-		,  textColor( Qt::white )
-		,  gridColor( Qt::white )
+		,  shownValue( 0.0 )
+		,  thresholdHysteresis( 0.0 )
+		,  thresholdSince( 0 )
+		,  samplesReceived( 0 )
+		,  framesRendered( 0 )
+		,  postedValue( 0.0 )
+		,  valuePosted( false )
+		,  draining( false )
 		,  q( parent )
 	{
+		clock.start();
+
+		// postValue() is documented as lock-free.
+		Q_ASSERT( postedValue.is_lock_free() && valuePosted.is_lock_free() &&
+			draining.is_lock_free() );
 	}
 
-	struct RangeData {
-		qreal start;
-		qreal stop;
-		QColor color;
+	~MeterPrivate()
+	{
+		stopAnimation();
+
+		if( windowWatcher )
+			windowWatcher->remove( this );
+	}
+
+	typedef MeterRendererPrivate::DrawParams DrawParams;
+
+	typedef MeterThresholdIndex::Band Band;
+
+	//! Instrumentation, allocated only when it's on.
+	struct Instrumentation {
+		MeterRenderStats stats;
+		//! Emits Meter::renderStatsUpdated() periodically.
+		QTimer timer;
+	};
+
+	//! Sample of the sliding window of extremes.
+	struct WindowSample {
+		qint64 time;
+		qreal value;
+	};
+
+	/*!
+		Sliding window of extremes, allocated only when it's on.
+		Times in each queue strictly increase, so a queue holds at
+		most extremesWindow + 1 samples.
+	*/
+	struct Extremes {
+		//! Candidates for maximum, values decrease from front to back.
+		std::deque< WindowSample > maxSamples;
+		//! Candidates for minimum, values increase from front to back.
+		std::deque< WindowSample > minSamples;
+		//! Expires the oldest sample when no new samples come.
+		QTimer expiryTimer;
+	};
+
+	//! \return Maximum value in the window.
+	qreal peak() const
+	{
+		return ( !extremes || extremes->maxSamples.empty() ? value :
+			extremes->maxSamples.front().value );
+	}
+
+	//! \return Minimum value in the window.
+	qreal trough() const
+	{
+		return ( !extremes || extremes->minSamples.empty() ? value :
+			extremes->minSamples.front().value );
+	}
+
+	//! Add sample taken at the time to the sliding window of extremes, markers aren't repainted.
+	void pushExtremes( qint64 time, qreal v );
+	//! Drop samples out of the window, the latest sample always stays.
+	void expireExtremes( qint64 now );
+	//! Expire samples on timer and schedule the next expiry.
+	void expiryTick();
+	//! Start expiry timer for the oldest sample if it's not started.
+	void scheduleExpiry();
+	//! Repaint markers if extremes changed.
+	void extremesChanged( qreal oldPeak, qreal oldTrough );
+	//! \return Region covered by the marker for the given value.
+	QRegion markerRegion( const DrawParams & params, qreal v ) const;
+	//! Draw peak and trough markers.
+	void drawExtremes( QPainter & painter, const DrawParams & params );
+
+	//! Min and max of samples within a column of the trail.
+	struct TrailColumn {
+		qreal min;
+		qreal max;
+		bool empty;
+	};
+
+	//! \return Count of columns of the trail, one per pixel.
+	int trailColumns() const;
+	//! \return Duration of a column of the trail in milliseconds.
+	qreal trailColumnTime() const
+	{
+		return qreal( trailTime ) / trail.size();
+	}
+	//! Rebuild columns of the trail from history.
+	void rebuildTrail();
+	//! Scroll the trail to the time.
+	void advanceTrail( qint64 now );
+	//! Add sample taken at the time to the trail and repaint changed columns.
+	void pushTrail( qint64 time, qreal v );
+	//! Draw history trail.
+	void drawTrail( QPainter & painter );
+	//! Add value taken at the time to history, trail and statistics if they are on.
+	void recordValue( qint64 time, qreal v );
+
+	//! Angles of the band of value statistics.
+	struct StatsBand {
+		StatsBand()
+			:  from( 0.0 )
+			,  to( 0.0 )
+			,  p95( 0.0 )
+			,  p99( 0.0 )
+			,  valid( false )
+		{
+		}
+
+		qreal from;
+		qreal to;
+		qreal p95;
+		qreal p99;
+		bool valid;
 	};
 
-	struct DrawParams {
-		QRectF rect;
-		qreal scaleDegree;
-		qreal startScaleAngle;
-		qreal margin;
-		qreal gridLabelSize;
-		qreal scaleWidth;
-		qreal fontPixelSize;
+	//! Statistics of values, allocated only when they are on.
+	struct ValueStats {
+		MeterValueStats stats;
+		//! The last drawn band of value statistics.
+		StatsBand drawn;
+	};
+
+	//! \return Band of the current value statistics.
+	StatsBand statsBand( const DrawParams & params ) const;
+	//! Repaint parts of the band moved by the last value.
+	void statsChanged();
+	//! Draw band of value statistics.
+	void drawStatsBand( QPainter & painter, const DrawParams & params );
+
+	//! Additional needle over the same face.
+	struct Needle {
+		Needle()
+			:  value( 0.0 )
+			,  currentBand( -1 )
+			,  currentThreshold( 0 )
+		{
+		}
+
+		qreal value;
+		QColor color;
+		QMultiMap< int, MeterRange > ranges;
+		MeterThresholdIndex bands;
+		//! Index of the band in bands with the current value or -1.
+		int currentBand;
+		int currentThreshold;
 	};
 
-	void drawBackground( QPainter & painter, DrawParams & params );
-	void drawRanges( QPainter & painter, DrawParams & params );
-	void drawScale( QPainter & painter, DrawParams & params );
-	void drawLabels( QPainter & painter, DrawParams & params );
-	void drawNeedle( QPainter & painter, DrawParams & params );
+	//! \return Additional needle by index of needle, 0 is the meter's own one.
+	Needle & needle( int index )
+	{
+		return needles[ index - 1 ];
+	}
+	//! \return Whether the index is of an additional needle.
+	bool isAdditionalNeedle( int index ) const
+	{
+		return ( index > 0 && index <= needles.size() );
+	}
+	//! \return Whether the needle entered another threshold.
+	bool needleThresholdFired( Needle & n ) const;
+	//! Repaint the needle moved from the old value.
+	void needleMoved( const Needle & n, qreal oldValue );
+	//! Draw additional needles.
+	void drawNeedles( QPainter & painter, const DrawParams & params );
+
+	//! Paint the meter, layers are timed into stats if given.
+	void paint( MeterRenderStats * stats = Q_NULLPTR );
+	//! Count and emit threshold signal.
+	void notifyThreshold( int thresholdIndex );
+
+	//! \return Drawing parameters for the current radius and angles, cached in the style.
+	const DrawParams & drawParams() const
+	{
+		return styleData()->drawParams();
+	}
+
+	//! \return Width of the text drawn from the atlas or -1 if the atlas lacks any character.
+	static qreal atlasTextWidth( const MeterGlyphAtlas & atlas, const QString & text );
+	void drawValueLabel( QPainter & painter, const DrawParams & params );
+	void drawNeedle( QPainter & painter, const DrawParams & params );
+
+	//! \return Value the needle points to, animated one in animated mode.
+	qreal drawnValue() const
+	{
+		return ( animated ? needleValue : value );
+	}
+
+	//! Start driving the needle to the value with the shared frame clock.
+	void startAnimation();
+	//! Stop animation, the needle stays where it is.
+	void stopAnimation();
+	//! Move the needle towards the value, spring with damping and slew limit.
+	bool advance( qreal dt ) Q_DECL_OVERRIDE;
+
+	//! \return Angle of the needle for the given value.
+	qreal needleAngle( const DrawParams & params, qreal v ) const;
+	//! \return Angle of the needle as it's drawn, i.e. quantized for sprites.
+	qreal drawnNeedleAngle( const DrawParams & params, qreal v ) const;
+	//! \return Region covered by the needle for the given value.
+	QRegion needleRegion( const DrawParams & params, qreal v ) const;
+	//! \return Region covered by the needle at the given angle.
+	QRegion needleRegionAt( const DrawParams & params, qreal angle ) const;
+	//! \return Region to repaint when value changes.
+	QRegion valueRegion( qreal oldValue, qreal newValue ) const;
+	//! \return Region of the value label text for both values, the whole label if not from atlas.
+	QRegion labelRegion( const DrawParams & params, qreal oldValue, qreal newValue ) const;
+	//! \return Does the needle move visibly from one value to another.
+	bool isNeedleMoved( qreal oldValue, qreal newValue ) const;
+	//! \return Text of the value label for the given value.
+	QString valueText( qreal v ) const;
+	//! \return Is the value in range of the meter.
+	bool isInRange( qreal v ) const;
+
+	//! Repaint the meter now or at the end of the transaction.
+	void requestUpdate();
+	//! \return Is the meter hidden or in minimized window.
+	bool isObscured() const;
+	//! \return Is there nothing of the meter to repaint.
+	bool isHiddenForPaint() const
+	{
+		return ( obscured || !exposed );
+	}
+	//! Re-check visibility, catch up when the meter is seen again.
+	void updateVisibility();
+	//! Watch state of the current top level window.
+	void watchWindow();
+	//! Window was minimized, maximized or restored.
+	void windowStateChanged() Q_DECL_OVERRIDE
+	{
+		updateVisibility();
+	}
+	//! Re-check thresholds after ranges changed, at the end of the transaction if any.
+	void thresholdsChanged();
+
+	//! Schedule repaint of the current value and emit valueChanged().
+	void presentValue();
+	//! Present the value now or on the next frame in coalescing mode.
+	void scheduleValue();
+	//! Frame tick in coalescing mode.
+	void frameTick();
+	//! Start frame timer of coalescing mode, it's created on first use.
+	void startFrameTimer();
+	//! Start timer re-checking thresholds when dwell time is over, it's created on first use.
+	void startDwellTimer( int ms );
+	//! \return Interval between frames in milliseconds.
+	int frameInterval() const;
+
+	//! \return Type of the event that wakes GUI thread on posted value.
+	static QEvent::Type postedValueEventType();
+	//! Apply value posted with Meter::postValue() and keep polling for the next ones.
+	void drainPostedValue();
+	//! Poll posted value each frame, stop polling after an idle frame.
+	void drainTick();
+
+	//! Check threshold of the value now by the meter's clock.
+	bool thresholdFired()
+	{
+		return thresholdFired( clock.elapsed() );
+	}
+	//! Check threshold of the value taken at the time by the meter's clock.
+	bool thresholdFired( qint64 now );
+
+	//! \return Settings for modification, only the given caches of MeterStyleData::Cache are dropped.
+	MeterSettings & editSettings( int caches )
+	{
+		return MeterStyleData::edit( style, caches );
+	}
+
+	//! \return Settings of the style.
+	const MeterSettings & settings() const
+	{
+		return style.settings();
+	}
 
-	bool thresholdFired();
+	//! \return Shared data of the style with caches.
+	const MeterStyleData * styleData() const
+	{
+		return MeterStyleData::get( style );
+	}
 
-	bool drawValue;
-	bool drawGridValues;
-	int valuePrecision;
-	int scalePrecision;
+	MeterStyle style;
+	bool perceptualFilter;
+	bool needleSprites;
+	bool coalescing;
+	//! Value was changed but not presented yet.
+	bool valueDirty;
+	//! Any threshold range was entered.
+	bool thresholdEntered;
+	//! Repaint is deferred till the end of the transaction.
+	bool updatePending;
+	//! Thresholds check is deferred till the end of the transaction.
+	bool thresholdsPending;
+	//! Depth of nested beginUpdate().
+	int updateDepth;
+	bool animated;
+	//! Needle is driven by the frame clock.
+	bool animating;
+	//! Approximate settle time of the needle in milliseconds.
+	int animationTime;
+	//! Damping ratio of the needle, 1 is critical damping, less overshoots.
+	qreal animationDamping;
+	//! Maximum speed of the needle in value units per second, 0 is unlimited.
+	qreal maxSlewRate;
+	//! Animated value the needle points to.
+	qreal needleValue;
+	qreal needleVelocity;
+	//! Interval of Meter::renderStatsUpdated() in milliseconds, 0 means never.
+	int statsInterval;
+	QScopedPointer< Instrumentation > instrumentation;
+	//! Meter can't be seen: it's hidden or its window is minimized.
+	bool obscured;
+	/*!
+		Any part of the meter is on the screen. Cached on show, move
+		and resize, a paint proves the meter is exposed again.
+	*/
+	bool exposed;
+	//! Something changed while obscured, repaint when seen again.
+	bool catchUpPending;
+	//! Shared watcher of the top level window.
+	QPointer< MeterWindowWatcher > windowWatcher;
+	//! Window of peak and trough tracking in milliseconds, 0 means off.
+	int extremesWindow;
+	QScopedPointer< Extremes > extremes;
+	MeterHistory history;
+	//! Time span of the trail in milliseconds, 0 means no trail.
+	int trailTime;
+	//! Ring of min and max decimated columns of the trail.
+	QVector< TrailColumn > trail;
+	//! Index of the newest column in trail.
+	int trailHead;
+	//! Start time of the newest column, fractional not to drift on short columns.
+	qreal trailHeadStart;
+	QScopedPointer< ValueStats > valueStats;
+	//! Half-life of value statistics in samples, kept while they are off.
+	int valueStatsHalfLife;
+	//! Window of value statistics in samples, kept while they are off.
+	int valueStatsWindow;
+	//! Additional needles, the meter's own needle isn't here.
+	QVector< Needle > needles;
 	int currentThreshold;
-	uint radius;
-	uint startScaleAngle;
-	uint stopScaleAngle;
-	qreal minValue;
-	qreal maxValue;
+	//! Index of the band in bands of the style with the current value or -1.
+	int currentBand;
+	int thresholdDwellTime;
+	//! Count of needle angles per full turn for sprites, 0 means no quantization.
+	int needleAngleSteps;
+	int frameRate;
 	qreal value;
-	qreal scaleStep;
-	qreal scaleGridStep;
-	QColor backgroundColor;
-	QColor needleColor;
-	QColor textColor;
-	QColor gridColor;
-	QString label;
-	QString unitsLabel;
-	QMultiMap< int, RangeData > ranges;
+	//! Value that is on the screen or scheduled to be painted.
+	qreal shownValue;
+	qreal thresholdHysteresis;
+	//! Time when current threshold was entered.
+	qint64 thresholdSince;
+	//! Text of the value label for shownValue, used by perceptual filter.
+	QString shownText;
+	quint64 samplesReceived;
+	quint64 framesRendered;
+	QScopedPointer< QTimer > frameTimer;
+	//! Re-checks thresholds when dwell time is over.
+	QScopedPointer< QTimer > dwellTimer;
+	QElapsedTimer clock;
+	//! Latest value posted from any thread.
+	std::atomic< qreal > postedValue;
+	//! Posted value is not drained yet.
+	std::atomic< bool > valuePosted;
+	//! GUI thread polls posted values, producers don't wake it.
+	std::atomic< bool > draining;
+	//! Polls posted values while they keep coming, it's created on first use.
+	QScopedPointer< QTimer > drainTimer;
 	Meter * q;
 }; // class MeterPrivate
 
 void
-MeterPrivate::drawBackground( QPainter & painter, DrawParams & params )
+MeterPrivate::pushExtremes( qint64 time, qreal v )
 {
-	painter.save();
-	painter.setPen( backgroundColor );
-	painter.setBrush( backgroundColor );
-	params.rect = QRectF( 0.0, 0.0, radius * 2, radius * 2 );
-	painter.drawEllipse( params.rect );
-	painter.restore();
+	std::deque< WindowSample > & maxSamples = extremes->maxSamples;
+	std::deque< WindowSample > & minSamples = extremes->minSamples;
+
+	// Times in queues don't decrease even if batches overlap in time.
+	if( !maxSamples.empty() )
+		time = qMax( time, maxSamples.back().time );
+
+	if( !minSamples.empty() )
+		time = qMax( time, minSamples.back().time );
+
+	// Samples dominated by the new one never become extremes.
+	while( !maxSamples.empty() && maxSamples.back().value <= v )
+		maxSamples.pop_back();
+
+	// The new sample is dominated by one taken at the same millisecond.
+	if( maxSamples.empty() || maxSamples.back().time < time )
+		maxSamples.push_back( { time, v } );
+
+	while( !minSamples.empty() && minSamples.back().value >= v )
+		minSamples.pop_back();
+
+	if( minSamples.empty() || minSamples.back().time < time )
+		minSamples.push_back( { time, v } );
+
+	expireExtremes( clock.elapsed() );
+	scheduleExpiry();
+}
+
+void
+MeterPrivate::expireExtremes( qint64 now )
+{
+	const qint64 oldest = now - extremesWindow;
+	std::deque< WindowSample > & maxSamples = extremes->maxSamples;
+	std::deque< WindowSample > & minSamples = extremes->minSamples;
+
+	while( maxSamples.size() > 1 && maxSamples.front().time <= oldest )
+		maxSamples.pop_front();
+
+	while( minSamples.size() > 1 && minSamples.front().time <= oldest )
+		minSamples.pop_front();
+}
+
+void
+MeterPrivate::expiryTick()
+{
+	const qreal oldPeak = peak();
+	const qreal oldTrough = trough();
+
+	expireExtremes( clock.elapsed() );
+	extremesChanged( oldPeak, oldTrough );
+	scheduleExpiry();
 }
 
 void
-MeterPrivate::drawRanges( QPainter & painter, DrawParams & params )
+MeterPrivate::scheduleExpiry()
 {
-	params.scaleDegree = stopScaleAngle - startScaleAngle;
-	params.startScaleAngle = startScaleAngle;
-	params.margin = radius / 20.0;
+	const std::deque< WindowSample > & maxSamples = extremes->maxSamples;
+	const std::deque< WindowSample > & minSamples = extremes->minSamples;
 
-	const qreal gridLabelSizeFactor = 10.0;
+	if( extremes->expiryTimer.isActive() || ( maxSamples.size() < 2 && minSamples.size() < 2 ) )
+		return;
 
-	params.scaleWidth = radius / ( gridLabelSizeFactor + 20.0 );
-	params.gridLabelSize = radius / gridLabelSizeFactor;
-	params.fontPixelSize = params.gridLabelSize * 0.75;
+	qint64 oldest = std::numeric_limits< qint64 >::max();
 
-	const qreal m = params.margin + params.scaleWidth / 2.0;
+	if( maxSamples.size() > 1 )
+		oldest = maxSamples.front().time;
 
-	const QRectF r = params.rect - QMarginsF( m, m, m,m );
+	if( minSamples.size() > 1 )
+		oldest = qMin( oldest, minSamples.front().time );
 
-	painter.save();
+	extremes->expiryTimer.start( static_cast< int > ( qMax( qint64( 0 ),
+		oldest + extremesWindow - clock.elapsed() ) + 1 ) );
+}
+
+void
+MeterPrivate::extremesChanged( qreal oldPeak, qreal oldTrough )
+{
+	const bool peakChanged = ( oldPeak != peak() );
+	const bool troughChanged = ( oldTrough != trough() );
 
-	for( auto it = ranges.cbegin(), last = ranges.cend(); it != last; ++it )
+	if( !peakChanged && !troughChanged )
+		return;
+
+	if( isHiddenForPaint() )
 	{
-		painter.setPen( QPen( it.value().color, params.scaleWidth ) );
-		const qreal angle = params.startScaleAngle +
-			params.scaleDegree * ( it.value().start / ( maxValue - minValue ) );
-		const qreal span = params.startScaleAngle +
-			params.scaleDegree * ( it.value().stop / ( maxValue - minValue ) ) - angle;
-		painter.drawArc( r, ( -90.0 - angle ) * 16, -span * 16 );
+		catchUpPending = true;
+
+		return;
 	}
 
-	painter.restore();
+	const DrawParams & params = drawParams();
+
+	QRegion region;
+
+	if( peakChanged )
+		region += markerRegion( params, oldPeak ) + markerRegion( params, peak() );
+
+	if( troughChanged )
+		region += markerRegion( params, oldTrough ) + markerRegion( params, trough() );
+
+	q->update( region & q->rect() );
+}
+
+QRegion
+MeterPrivate::markerRegion( const DrawParams & params, qreal v ) const
+{
+	const qreal w = MeterRendererPrivate::markerWidth( params ) / 2.0 + 1.0;
+	const QPointF center( settings().radius + 1.0, settings().radius + 1.0 );
+	const QLineF line = MeterRendererPrivate::markerLine( settings(), params,
+		needleAngle( params, v ) ).translated( center );
+
+	return QRegion( QRectF( line.p1(), line.p2() ).normalized()
+		.adjusted( -w, -w, w, w ).toAlignedRect() );
 }
 
 void
-MeterPrivate::drawScale( QPainter & painter, DrawParams & params )
+MeterPrivate::drawExtremes( QPainter & painter, const DrawParams & params )
 {
 	painter.save();
-	painter.setPen( textColor );
-	painter.drawArc( params.rect -
-	QMarginsF( params.margin, params.margin, params.margin, params.margin ),
-		( -90.0 - params.startScaleAngle ) * 16, -params.scaleDegree * 16 );
-	painter.translate( radius, radius );
-	painter.rotate( params.startScaleAngle );
+	painter.translate( settings().radius, settings().radius );
+
+	MeterRendererPrivate::drawMarker( painter, settings(), params,
+		needleAngle( params, peak() ) );
+	MeterRendererPrivate::drawMarker( painter, settings(), params,
+		needleAngle( params, trough() ) );
 
-	QVector< qreal > alreadyDrawn;
-	alreadyDrawn.append( params.startScaleAngle );
+	painter.restore();
+}
+
+int
+MeterPrivate::trailColumns() const
+{
+	return qMax( 1, qRound( MeterRendererPrivate::trailRect( settings() ).width() ) );
+}
+
+void
+MeterPrivate::rebuildTrail()
+{
+	const int columns = trailColumns();
+	const qint64 now = clock.elapsed();
+
+	trail.fill( { 0.0, 0.0, true }, columns );
+	trailHead = columns - 1;
+	trailHeadStart = now;
 
-	if( scaleGridStep > 0.0 )
+	const qreal columnTime = trailColumnTime();
+
+	for( int i = 0; i < history.size(); ++i )
 	{
-		const int stepsCount = ( ( maxValue - minValue ) / scaleGridStep );
-		const qreal scaleStepInDegree = params.scaleDegree / stepsCount;
+		const MeterSample & s = history.at( i );
+		const int k = qCeil( ( now - s.time ) / columnTime );
 
-		for( int i = 0; i <= stepsCount; ++i )
+		if( k >= 0 && k < columns )
 		{
-			painter.drawLine( 0, radius - params.margin, 0,
-			radius - params.gridLabelSize - params.margin );
-			painter.rotate( scaleStepInDegree );
-			alreadyDrawn.append( params.startScaleAngle + i * scaleStepInDegree );
+			TrailColumn & c = trail[ trailHead - k ];
+
+			c.min = ( c.empty ? s.value : qMin( c.min, s.value ) );
+			c.max = ( c.empty ? s.value : qMax( c.max, s.value ) );
+			c.empty = false;
 		}
 	}
+}
+
+void
+MeterPrivate::advanceTrail( qint64 now )
+{
+	const qreal columnTime = trailColumnTime();
+	const qint64 k = static_cast< qint64 > ( qFloor( ( now - trailHeadStart ) / columnTime ) );
+
+	if( k <= 0 )
+		return;
+
+	for( qint64 i = 0, last = qMin( k, qint64( trail.size() ) ); i < last; ++i )
+	{
+		trailHead = ( trailHead + 1 ) % trail.size();
+		trail[ trailHead ].empty = true;
+	}
+
+	trailHeadStart += k * columnTime;
+}
+
+void
+MeterPrivate::pushTrail( qint64 time, qreal v )
+{
+	if( trail.isEmpty() )
+		rebuildTrail();
+
+	const int head = trailHead;
+
+	advanceTrail( time );
+
+	// Samples of a batch may be older than the newest column.
+	const int k = ( time < trailHeadStart ?
+		qCeil( ( trailHeadStart - time ) / trailColumnTime() ) : 0 );
+
+	if( k >= trail.size() )
+		return;
+
+	const int column = ( trailHead - k + trail.size() ) % trail.size();
+
+	TrailColumn & c = trail[ column ];
+
+	if( head == trailHead && !c.empty && v >= c.min && v <= c.max )
+		return;
+
+	c.min = ( c.empty ? v : qMin( c.min, v ) );
+	c.max = ( c.empty ? v : qMax( c.max, v ) );
+	c.empty = false;
+
+	if( updateDepth > 0 )
+	{
+		updatePending = true;
+
+		return;
+	}
+	else if( isHiddenForPaint() )
+	{
+		catchUpPending = true;
+
+		return;
+	}
+
+	QRectF rect = MeterRendererPrivate::trailRect( settings() ).translated( 1.0, 1.0 );
+
+	// Only the newest column changes unless the trail scrolls.
+	if( head == trailHead && k == 0 )
+		rect.setLeft( rect.right() - 1.0 );
+
+	q->update( rect.toAlignedRect().adjusted( -1, -1, 1, 1 ) & q->rect() );
+}
+
+void
+MeterPrivate::recordValue( qint64 time, qreal v )
+{
+	if( valueStats )
+	{
+		valueStats->stats.add( v );
+		statsChanged();
+	}
+
+	if( history.capacity() == 0 && trailTime == 0 )
+		return;
+
+	history.append( time, v );
+
+	if( trailTime > 0 )
+		pushTrail( time, v );
+}
+
+void
+MeterPrivate::drawTrail( QPainter & painter )
+{
+	if( trail.size() != trailColumns() )
+		rebuildTrail();
 	else
+		advanceTrail( clock.elapsed() );
+
+	const QRectF rect = MeterRendererPrivate::trailRect( settings() );
+	const qreal range = settings().maxValue - settings().minValue;
+
+	if( range <= 0.0 )
+		return;
+
+	const qreal scale = rect.height() / range;
+	const int columns = trail.size();
+
+	QVector< QLineF > lines;
+	lines.reserve( columns );
+
+	// Cost depends on width of the trail in pixels, not on count of samples.
+	for( int i = 0; i < columns; ++i )
 	{
-		painter.drawLine( 0, radius - params.margin, 0,
-		radius - params.gridLabelSize - params.margin );
+		const TrailColumn & c = trail.at( ( trailHead + 1 + i ) % columns );
 
-		painter.rotate( params.scaleDegree );
+		if( c.empty )
+			continue;
 
-		alreadyDrawn.append( params.scaleDegree );
+		const qreal x = rect.left() + i + 0.5;
+		const qreal y1 = rect.bottom() - ( c.min - settings().minValue ) * scale;
+		const qreal y2 = rect.bottom() - ( c.max - settings().minValue ) * scale;
 
-		painter.drawLine( 0, radius - params.margin, 0,
-		radius - params.gridLabelSize - params.margin );
+		lines.append( QLineF( x, y1 + 0.5, x, y2 - 0.5 ) );
 	}
 
+	QColor color = settings().needleColor;
+	color.setAlphaF( 0.5 );
+
+	painter.save();
+	painter.setRenderHint( QPainter::Antialiasing, false );
+	painter.setPen( QPen( color, 0.0 ) );
+	painter.drawLines( lines );
 	painter.restore();
+}
 
-	if( scaleStep > 0.0 )
+MeterPrivate::StatsBand
+MeterPrivate::statsBand( const DrawParams & params ) const
+{
+	StatsBand band;
+	const MeterValueStats & stats = valueStats->stats;
+
+	if( stats.count() == 0 )
+		return band;
+
+	const qreal minValue = settings().minValue;
+	const qreal maxValue = settings().maxValue;
+	const qreal sd = stats.standardDeviation();
+
+	band.from = needleAngle( params,
+		qBound( minValue, stats.mean() - sd, maxValue ) );
+	band.to = needleAngle( params,
+		qBound( minValue, stats.mean() + sd, maxValue ) );
+	band.p95 = needleAngle( params, qBound( minValue, stats.p95(), maxValue ) );
+	band.p99 = needleAngle( params, qBound( minValue, stats.p99(), maxValue ) );
+	band.valid = true;
+
+	return band;
+}
+
+void
+MeterPrivate::statsChanged()
+{
+	const DrawParams & params = drawParams();
+
+	const StatsBand band = statsBand( params );
+	const qreal outer = MeterRendererPrivate::statsBandOuter( settings(), params );
+	const qreal inner = MeterRendererPrivate::statsBandInner( settings(), params );
+
+	// Movement less than half of a pixel on the band isn't visible.
+	const qreal eps = qRadiansToDegrees( 0.5 / outer );
+
+	const StatsBand & old = valueStats->drawn;
+
+	if( old.valid && qAbs( old.from - band.from ) < eps &&
+		qAbs( old.to - band.to ) < eps && qAbs( old.p95 - band.p95 ) < eps &&
+		qAbs( old.p99 - band.p99 ) < eps )
+		return;
+
+	if( updateDepth > 0 )
 	{
-		painter.save();
-		painter.setPen( textColor );
-		painter.translate( radius, radius );
-		painter.rotate( params.startScaleAngle );
+		updatePending = true;
+
+		return;
+	}
+	else if( isHiddenForPaint() )
+	{
+		catchUpPending = true;
+
+		return;
+	}
+
+	QRectF rect;
+
+	if( old.valid )
+	{
+		rect = MeterRendererPrivate::sectorRect( old.from, band.from, inner, outer )
+			.united( MeterRendererPrivate::sectorRect( old.to, band.to, inner, outer ) )
+			.united( MeterRendererPrivate::sectorRect( old.p95, band.p95, inner, outer ) )
+			.united( MeterRendererPrivate::sectorRect( old.p99, band.p99, inner, outer ) );
+	}
+	else
+	{
+		rect = MeterRendererPrivate::sectorRect( band.from, band.to, inner, outer )
+			.united( MeterRendererPrivate::sectorRect( band.p95, band.p99, inner, outer ) );
+	}
+
+	const qreal w = params.scaleWidth + 1.0;
+	const qreal c = settings().radius + 1.0;
 
-		int stepsCount = ( ( maxValue - minValue ) / scaleStep );
-		const qreal scaleStepInDegree = params.scaleDegree / stepsCount;
+	q->update( rect.translated( c, c ).adjusted( -w, -w, w, w ).toAlignedRect() & q->rect() );
 
-		stepsCount -= 2;
+	valueStats->drawn = band;
+}
 
-		painter.rotate( scaleStepInDegree );
+void
+MeterPrivate::drawStatsBand( QPainter & painter, const DrawParams & params )
+{
+	const StatsBand & band = valueStats->drawn = statsBand( params );
 
-		for( int i = 0; i <= stepsCount; ++i )
-		{
-			if( !alreadyDrawn.contains( ( params.startScaleAngle + scaleStepInDegree )
-				+ i * scaleStepInDegree ) )
-					painter.drawLine( 0, radius - params.margin, 0,
-						radius - params.scaleWidth - params.margin );
+	if( !band.valid )
+		return;
 
-			painter.rotate( scaleStepInDegree );
+	painter.save();
+	painter.translate( settings().radius, settings().radius );
+
+	MeterRendererPrivate::drawStatsBand( painter, settings(), params,
+		band.from, band.to, band.p95, band.p99 );
+
+	painter.restore();
+}
+
+bool
+MeterPrivate::needleThresholdFired( Needle & n ) const
+{
+	if( n.currentBand >= 0 )
+	{
+		const MeterThresholdIndex::Band & b = n.bands.at( n.currentBand );
+
+		if( n.value >= b.start - thresholdHysteresis && n.value < b.stop + thresholdHysteresis )
+			return false;
+	}
+
+	n.currentBand = n.bands.find( n.value );
+
+	if( n.currentBand < 0 || n.bands.at( n.currentBand ).thresholdIndex == n.currentThreshold )
+		return false;
+
+	n.currentThreshold = n.bands.at( n.currentBand ).thresholdIndex;
+
+	return true;
+}
+
+void
+MeterPrivate::needleMoved( const Needle & n, qreal oldValue )
+{
+	if( updateDepth > 0 )
+	{
+		updatePending = true;
+
+		return;
+	}
+	else if( isHiddenForPaint() )
+	{
+		catchUpPending = true;
+
+		return;
+	}
+
+	const DrawParams & params = drawParams();
+
+	const qreal oldAngle = needleAngle( params, oldValue );
+	const qreal newAngle = needleAngle( params, n.value );
+
+	// Nothing to repaint if the needle moved less than a pixel at its tip.
+	if( qAbs( newAngle - oldAngle ) < qRadiansToDegrees( 0.5 / settings().radius ) )
+		return;
+
+	q->update( ( needleRegionAt( params, oldAngle ) + needleRegionAt( params, newAngle ) ) &
+		q->rect() );
+}
+
+void
+MeterPrivate::drawNeedles( QPainter & painter, const DrawParams & params )
+{
+	for( const Needle & n : qAsConst( needles ) )
+		MeterRendererPrivate::drawNeedle( painter, settings(), params,
+			needleAngle( params, n.value ), n.color );
+}
+
+void
+MeterPrivate::paint( MeterRenderStats * stats )
+{
+	QElapsedTimer total;
+	QElapsedTimer timer;
+
+	if( stats )
+	{
+		total.start();
+		timer.start();
+	}
+
+	// Add time since the previous layer to the given one.
+	const auto lap = [stats, &timer] ( MeterRenderStats::Layer layer )
+	{
+		if( stats )
+		{
+			stats->layerTime[ layer ] += timer.nsecsElapsed();
+			timer.start();
 		}
+	};
 
-		painter.restore();
+	const DrawParams & params = drawParams();
+
+	QPainter p( q );
+	p.drawPixmap( 0, 0, styleData()->face( q->devicePixelRatioF(), stats ) );
+	p.setRenderHint( QPainter::Antialiasing );
+	p.translate( 1.0, 1.0 );
+	lap( MeterRenderStats::Face );
+
+	if( valueStats )
+		drawStatsBand( p, params );
+
+	if( extremesWindow > 0 )
+		drawExtremes( p, params );
+
+	if( trailTime > 0 )
+		drawTrail( p );
+
+	lap( MeterRenderStats::Overlays );
+
+	drawValueLabel( p, params );
+	lap( MeterRenderStats::ValueLabel );
+
+	drawNeedles( p, params );
+	drawNeedle( p, params );
+	lap( MeterRenderStats::Needle );
+
+	if( stats )
+	{
+		++stats->paints;
+		stats->addPaintTime( total.nsecsElapsed() );
 	}
 }
 
 void
-MeterPrivate::drawLabels( QPainter & painter, DrawParams & params )
+MeterPrivate::notifyThreshold( int thresholdIndex )
+{
+	if( instrumentation )
+		++instrumentation->stats.thresholdSignals;
+
+	emit q->thresholdFired( thresholdIndex );
+	emit q->needleThresholdFired( 0, thresholdIndex );
+}
+
+qreal
+MeterPrivate::atlasTextWidth( const MeterGlyphAtlas & atlas, const QString & text )
+{
+	qreal width = 0.0;
+
+	for( const QChar & c : text )
+	{
+		const int i = MeterGlyphAtlas::index( c );
+
+		if( i < 0 )
+			return -1.0;
+
+		width += atlas.advances[ i ];
+	}
+
+	return width;
+}
+
+void
+MeterPrivate::drawValueLabel( QPainter & painter, const DrawParams & params )
+{
+	if( settings().drawValue )
+	{
+		const MeterGlyphAtlas & atlas =
+			styleData()->atlas( painter.device()->devicePixelRatioF() );
+		const QString text = valueText( value );
+		const QRectF rect = MeterRendererPrivate::valueLabelRect( settings(), params );
+		const qreal width = atlasTextWidth( atlas, text );
+
+		if( width >= 0.0 )
+		{
+			qreal x = rect.x() + ( rect.width() - width ) / 2.0;
+
+			for( const QChar & c : text )
+			{
+				const int i = MeterGlyphAtlas::index( c );
+
+				painter.drawPixmap( QPointF( x - atlas.padding, rect.y() ),
+					atlas.pixmap, atlas.rects[ i ] );
+
+				x += atlas.advances[ i ];
+			}
+		}
+		else
+			MeterRendererPrivate::drawValueLabel( painter, settings(), params, value );
+	}
+}
+
+void
+MeterPrivate::drawNeedle( QPainter & painter, const DrawParams & params )
+{
+	if( needleSprites )
+	{
+		const qreal dpr = painter.device()->devicePixelRatioF();
+		const MeterNeedleSprites & sprites = styleData()->sprites( needleAngleSteps, dpr );
+		const QPointF center( settings().radius, settings().radius );
+		const MeterNeedleSprite * sprite = Q_NULLPTR;
+
+		if( needleAngleSteps > 0 )
+			sprite = styleData()->needleSprite( needleAngleSteps, dpr,
+				qRound( needleAngle( params, drawnValue() ) * needleAngleSteps / 360.0 ) );
+
+		if( sprite )
+			painter.drawPixmap( center + sprite->offset, sprite->pixmap );
+		else
+			MeterRendererPrivate::drawNeedle( painter, settings(), params,
+				drawnNeedleAngle( params, drawnValue() ) );
+
+		painter.drawPixmap( center + sprites.hubOffset, sprites.hub );
+	}
+	else
+	{
+		MeterRendererPrivate::drawNeedle( painter, settings(), params,
+			needleAngle( params, drawnValue() ) );
+
+		painter.save();
+		painter.translate( settings().radius, settings().radius );
+		MeterRendererPrivate::drawHub( painter, settings() );
+		painter.restore();
+	}
+}
+
+qreal
+MeterPrivate::needleAngle( const DrawParams & params, qreal v ) const
+{
+	return MeterRendererPrivate::needleAngle( settings(), params, v );
+}
+
+qreal
+MeterPrivate::drawnNeedleAngle( const DrawParams & params, qreal v ) const
+{
+	const qreal angle = needleAngle( params, v );
+
+	if( needleSprites && needleAngleSteps > 0 )
+		return qRound( angle * needleAngleSteps / 360.0 ) * 360.0 / needleAngleSteps;
+	else
+		return angle;
+}
+
+QRegion
+MeterPrivate::needleRegion( const DrawParams & params, qreal v ) const
+{
+	return needleRegionAt( params, drawnNeedleAngle( params, v ) );
+}
+
+QRegion
+MeterPrivate::needleRegionAt( const DrawParams & params, qreal angle ) const
+{
+	// Needle is covered with a few rectangles along it, that is much
+	// smaller than one bounding rectangle of the diagonal needle.
+	static const int c_segments = 4;
+
+	const qreal radius = settings().radius;
+	const qreal w = radius / 75.0 + 2.0;
+	const QPointF center( radius + 1.0, radius + 1.0 );
+	const QLineF line = MeterRendererPrivate::tickLine( angle,
+		radius - params.margin, - radius / 10.0 * 2.0 );
+	const QPointF p1 = center + line.p1();
+	const QPointF p2 = center + line.p2();
+
+	QRegion region;
+
+	for( int i = 0; i < c_segments; ++i )
+	{
+		const QPointF s1 = p1 + ( p2 - p1 ) * ( qreal( i ) / c_segments );
+		const QPointF s2 = p1 + ( p2 - p1 ) * ( qreal( i + 1 ) / c_segments );
+
+		region += QRectF( s1, s2 ).normalized().adjusted( -w, -w, w, w ).toAlignedRect();
+	}
+
+	return region;
+}
+
+QRegion
+MeterPrivate::valueRegion( qreal oldValue, qreal newValue ) const
+{
+	const DrawParams & params = drawParams();
+
+	QRegion region = needleRegion( params, oldValue ) + needleRegion( params, newValue );
+
+	if( settings().drawValue )
+		region += labelRegion( params, oldValue, newValue );
+
+	return region & q->rect();
+}
+
+QRegion
+MeterPrivate::labelRegion( const DrawParams & params, qreal oldValue, qreal newValue ) const
+{
+	const QRectF label = MeterRendererPrivate::valueLabelRect( settings(), params );
+	const MeterGlyphAtlas & atlas = styleData()->atlas( q->devicePixelRatioF() );
+	const qreal height = atlas.rects[ 0 ].height() / atlas.dpr;
+
+	QRectF rect;
+
+	// Only glyphs of the old and the new text are repainted, not the whole strip.
+	for( const qreal v : { oldValue, newValue } )
+	{
+		const qreal width = atlasTextWidth( atlas, valueText( v ) );
+
+		if( width < 0.0 )
+			return QRegion( label.translated( 1.0, 1.0 ).toAlignedRect() );
+
+		rect = rect.united( QRectF( label.x() + ( label.width() - width ) / 2.0 -
+			atlas.padding, label.y(), width + atlas.padding * 2, height ) );
+	}
+
+	return QRegion( rect.translated( 1.0, 1.0 ).toAlignedRect().adjusted( -1, -1, 1, 1 ) );
+}
+
+bool
+MeterPrivate::isNeedleMoved( qreal oldValue, qreal newValue ) const
+{
+	const DrawParams & params = drawParams();
+
+	// Angle that moves the tip of the needle by a half of pixel.
+	const qreal epsilon = qRadiansToDegrees( 0.5 / ( settings().radius - params.margin ) );
+
+	return ( qAbs( drawnNeedleAngle( params, newValue ) -
+		drawnNeedleAngle( params, oldValue ) ) >= epsilon );
+}
+
+QString
+MeterPrivate::valueText( qreal v ) const
+{
+	return MeterRendererPrivate::valueText( settings(), v );
+}
+
+void
+MeterPrivate::requestUpdate()
+{
+	if( updateDepth > 0 )
+		updatePending = true;
+	else if( obscured )
+		catchUpPending = true;
+	else
+		q->update();
+}
+
+bool
+MeterPrivate::isObscured() const
+{
+	return ( !q->isVisible() || q->window()->isMinimized() );
+}
+
+void
+MeterPrivate::updateVisibility()
+{
+	const bool o = isObscured();
+	const bool e = ( !o && !q->visibleRegion().isEmpty() );
+
+	if( o == obscured && e == exposed )
+		return;
+
+	obscured = o;
+	exposed = e;
+
+	if( obscured )
+	{
+		// Nobody sees the needle moving, it jumps to the value on catch up.
+		if( animating )
+		{
+			stopAnimation();
+
+			needleValue = value;
+			needleVelocity = 0.0;
+		}
+	}
+	else if( exposed && catchUpPending )
+	{
+		catchUpPending = false;
+
+		q->update();
+	}
+}
+
+void
+MeterPrivate::watchWindow()
+{
+	QWidget * w = q->window();
+
+	if( windowWatcher && windowWatcher->window() == w )
+		return;
+
+	if( windowWatcher )
+		windowWatcher->remove( this );
+
+	windowWatcher = MeterWindowWatcher::watch( w, this );
+}
+
+void
+MeterPrivate::thresholdsChanged()
+{
+	currentBand = -1;
+
+	if( updateDepth > 0 )
+		thresholdsPending = true;
+	else if( thresholdFired() )
+		notifyThreshold( currentThreshold );
+}
+
+bool
+MeterPrivate::isInRange( qreal v ) const
+{
+	return ( ( v > settings().minValue || qAbs( v - settings().minValue ) < 0.000001 ) &&
+		( v < settings().maxValue || qAbs( v - settings().maxValue ) < 0.000001 ) );
+}
+
+void
+MeterPrivate::presentValue()
+{
+	if( perceptualFilter )
+	{
+		const QString text = ( settings().drawValue ? valueText( value ) : QString() );
+
+		if( !isNeedleMoved( shownValue, value ) && text == shownText )
+		{
+			if( instrumentation )
+				++instrumentation->stats.skippedUpdates;
+
+			return;
+		}
+
+		shownText = text;
+	}
+
+	if( isHiddenForPaint() )
+	{
+		// Value is exact, the latest state is painted when the meter is seen again.
+		catchUpPending = true;
+
+		if( animated )
+		{
+			stopAnimation();
+
+			needleValue = value;
+			needleVelocity = 0.0;
+		}
+	}
+	else if( animated )
+	{
+		// Needle is repainted by animation frames.
+		if( settings().drawValue )
+		{
+			const DrawParams & params = drawParams();
+
+			q->update( labelRegion( params, shownValue, value ) & q->rect() );
+		}
+
+		startAnimation();
+	}
+	else
+		q->update( valueRegion( shownValue, value ) );
+
+	shownValue = value;
+
+	emit q->valueChanged( value );
+	emit q->needleValueChanged( 0, value );
+}
+
+void
+MeterPrivate::startAnimation()
+{
+	if( !animating )
+	{
+		MeterFrameClock * frameClock = MeterFrameClock::instance();
+
+		if( frameClock )
+		{
+			animating = true;
+
+			frameClock->add( this );
+		}
+	}
+}
+
+void
+MeterPrivate::stopAnimation()
+{
+	if( animating )
+	{
+		animating = false;
+
+		MeterFrameClock * frameClock = MeterFrameClock::instance();
+
+		if( frameClock )
+			frameClock->remove( this );
+	}
+}
+
+bool
+MeterPrivate::advance( qreal dt )
+{
+	const DrawParams & params = drawParams();
+
+	const qreal old = needleValue;
+	const qreal omega = 4000.0 / animationTime;
+	// Sub-steps keep integration of the stiff spring stable.
+	const int steps = qMax( 1, qCeil( dt * omega / 0.25 ) );
+	const qreal h = dt / steps;
+
+	for( int i = 0; i < steps; ++i )
+	{
+		const qreal a = omega * omega * ( value - needleValue ) -
+			2.0 * animationDamping * omega * needleVelocity;
+
+		needleVelocity += a * h;
+
+		if( maxSlewRate > 0.0 )
+			needleVelocity = qBound( -maxSlewRate, needleVelocity, maxSlewRate );
+
+		needleValue += needleVelocity * h;
+	}
+
+	// Settled when the needle is at the target and would not move visibly in a frame.
+	const bool settled = !isNeedleMoved( needleValue, value ) &&
+		!isNeedleMoved( needleValue, needleValue + needleVelocity * 0.016 );
+
+	if( settled )
+	{
+		needleValue = value;
+		needleVelocity = 0.0;
+		animating = false;
+	}
+
+	q->update( ( needleRegion( params, old ) + needleRegion( params, needleValue ) ) &
+		q->rect() );
+
+	return !settled;
+}
+
+void
+MeterPrivate::scheduleValue()
+{
+	if( !coalescing )
+		presentValue();
+	else if( frameTimer && frameTimer->isActive() )
+	{
+		if( valueDirty && instrumentation )
+			++instrumentation->stats.samplesCoalesced;
+
+		valueDirty = true;
+	}
+	else
+	{
+		presentValue();
+
+		startFrameTimer();
+	}
+}
+
+void
+MeterPrivate::frameTick()
+{
+	drainPostedValue();
+
+	if( valueDirty )
+	{
+		valueDirty = false;
+
+		presentValue();
+	}
+	else
+		frameTimer->stop();
+}
+
+void
+MeterPrivate::startFrameTimer()
+{
+	if( !frameTimer )
+	{
+		frameTimer.reset( new QTimer );
+		frameTimer->setTimerType( Qt::PreciseTimer );
+
+		QObject::connect( frameTimer.data(), &QTimer::timeout, q,
+			[this] () { frameTick(); } );
+	}
+
+	frameTimer->start( frameInterval() );
+}
+
+void
+MeterPrivate::startDwellTimer( int ms )
+{
+	if( !dwellTimer )
+	{
+		dwellTimer.reset( new QTimer );
+		dwellTimer->setSingleShot( true );
+
+		QObject::connect( dwellTimer.data(), &QTimer::timeout, q,
+			[this] ()
+			{
+				if( thresholdFired() )
+					notifyThreshold( currentThreshold );
+			} );
+	}
+
+	dwellTimer->start( ms );
+}
+
+int
+MeterPrivate::frameInterval() const
+{
+	qreal fps = frameRate;
+
+	if( fps <= 0.0 )
+	{
+		const QWindow * w = q->window()->windowHandle();
+		const QScreen * s = ( w ? w->screen() : QGuiApplication::primaryScreen() );
+
+		fps = ( s && s->refreshRate() > 0.0 ? s->refreshRate() : 60.0 );
+	}
+
+	return qMax( 1, qRound( 1000.0 / fps ) );
+}
+
+QEvent::Type
+MeterPrivate::postedValueEventType()
+{
+	static const QEvent::Type type =
+		static_cast< QEvent::Type > ( QEvent::registerEventType() );
+
+	return type;
+}
+
+void
+MeterPrivate::drainPostedValue()
+{
+	if( !valuePosted.exchange( false ) )
+		return;
+
+	if( !draining.load( std::memory_order_relaxed ) )
+	{
+		if( !drainTimer )
+		{
+			drainTimer.reset( new QTimer );
+
+			QObject::connect( drainTimer.data(), &QTimer::timeout, q,
+				[this] () { drainTick(); } );
+		}
+
+		draining.store( true );
+		drainTimer->start( frameInterval() );
+	}
+
+	q->setValue( postedValue.load( std::memory_order_relaxed ) );
+}
+
+void
+MeterPrivate::drainTick()
+{
+	if( valuePosted.exchange( false ) )
+	{
+		q->setValue( postedValue.load( std::memory_order_relaxed ) );
+
+		return;
+	}
+
+	draining.store( false );
+	drainTimer->stop();
+
+	// A producer could see draining before it was cleared, so it didn't wake us.
+	drainPostedValue();
+}
+
+bool
+MeterPrivate::thresholdFired( qint64 now )
+{
+	if( currentBand >= 0 )
+	{
+		const Band & b = styleData()->bands().at( currentBand );
+
+		if( value >= b.start - thresholdHysteresis && value < b.stop + thresholdHysteresis )
+			return false;
+	}
+
+	const int band = styleData()->bands().find( value );
+
+	if( band < 0 )
+	{
+		currentBand = -1;
+
+		return false;
+	}
+
+	if( styleData()->bands().at( band ).thresholdIndex == currentThreshold )
+	{
+		currentBand = band;
+
+		return false;
+	}
+
+	if( thresholdEntered && thresholdDwellTime > 0 )
+	{
+		const qint64 left = thresholdSince + thresholdDwellTime - now;
+
+		if( left > 0 )
+		{
+			if( !dwellTimer || !dwellTimer->isActive() )
+				startDwellTimer( static_cast< int > ( left ) );
+
+			return false;
+		}
+	}
+
+	currentBand = band;
+	currentThreshold = styleData()->bands().at( band ).thresholdIndex;
+	thresholdSince = now;
+	thresholdEntered = true;
+
+	return true;
+}
+
+
+//
+// Meter
+//
+
+Meter::Meter( QWidget * parent )
+	:  QWidget( parent )
+	,  d( new MeterPrivate( this ) )
+{
+	setSizePolicy( QSizePolicy::Fixed, QSizePolicy::Fixed );
+
+	d->editSettings( MeterStyleData::Text | MeterStyleData::Atlas ).font = font();
+}
+
+Meter::~Meter()
+{
+}
+
+qreal
+Meter::minValue() const
+{
+	return d->settings().minValue;
+}
+
+void
+Meter::setMinValue( qreal v )
+{
+	MeterSettings & s = d->editSettings( MeterStyleData::Geometry );
+	s.minValue = v;
+
+	if( s.minValue > s.maxValue )
+		s.maxValue = s.minValue;
+
+	d->requestUpdate();
+}
+
+qreal
+Meter::maxValue() const
+{
+	return d->settings().maxValue;
+}
+
+void
+Meter::setMaxValue( qreal v )
+{
+	MeterSettings & s = d->editSettings( MeterStyleData::Geometry );
+	s.maxValue = v;
+
+	if( s.minValue > s.maxValue )
+		s.minValue = s.maxValue;
+
+	d->requestUpdate();
+}
+
+const MeterScale &
+Meter::scale() const
+{
+	return d->settings().scale;
+}
+
+void
+Meter::setScale( const MeterScale & s )
+{
+	if( s != d->settings().scale )
+	{
+		d->editSettings( MeterStyleData::Geometry ).scale = s;
+
+		d->requestUpdate();
+	}
+}
+
+qreal
+Meter::value() const
+{
+	return d->value;
+}
+
+void
+Meter::setValue( qreal v )
+{
+	if( d->isInRange( v ) )
+	{
+		++d->samplesReceived;
+
+		if( d->instrumentation )
+			++d->instrumentation->stats.samplesReceived;
+
+		const qreal oldPeak = d->peak();
+		const qreal oldTrough = d->trough();
+
+		d->value = v;
+
+		d->recordValue( d->clock.elapsed(), v );
+
+		if( d->extremesWindow > 0 )
+		{
+			d->pushExtremes( d->clock.elapsed(), v );
+			d->extremesChanged( oldPeak, oldTrough );
+		}
+
+		d->scheduleValue();
+
+		if( d->thresholdFired() )
+			d->notifyThreshold( d->currentThreshold );
+	}
+}
+
+QVector< MeterCrossing >
+Meter::setValues( const qreal * values, int count, const qint64 * timestamps )
+{
+	QVector< MeterCrossing > crossings;
+	bool accepted = false;
+	const qreal oldPeak = d->peak();
+	const qreal oldTrough = d->trough();
+
+	// Timestamps are moved to the meter's clock, the last sample is taken now.
+	const qint64 now = d->clock.elapsed();
+	const qint64 offset = ( timestamps && count > 0 ? now - timestamps[ count - 1 ] : 0 );
+
+	for( int i = 0; i < count; ++i )
+	{
+		if( d->isInRange( values[ i ] ) )
+		{
+			++d->samplesReceived;
+
+			if( d->instrumentation )
+				++d->instrumentation->stats.samplesReceived;
+
+			d->value = values[ i ];
+
+			const qint64 time = ( timestamps ? qMin( timestamps[ i ] + offset, now ) : now );
+
+			d->recordValue( time, values[ i ] );
+
+			if( d->extremesWindow > 0 )
+				d->pushExtremes( time, values[ i ] );
+
+			accepted = true;
+
+			if( d->thresholdFired( time ) )
+				crossings.append( { i, ( timestamps ? timestamps[ i ] : -1 ),
+					d->currentThreshold } );
+		}
+	}
+
+	if( accepted )
+	{
+		d->scheduleValue();
+
+		// Markers are repainted once for the whole batch.
+		if( d->extremesWindow > 0 )
+			d->extremesChanged( oldPeak, oldTrough );
+	}
+
+	for( const MeterCrossing & c : qAsConst( crossings ) )
+		d->notifyThreshold( c.thresholdIndex );
+
+	return crossings;
+}
+
+QVector< MeterCrossing >
+Meter::setValues( const QVector< qreal > & values, const QVector< qint64 > & timestamps )
+{
+	return setValues( values.constData(), values.size(),
+		( timestamps.size() == values.size() ? timestamps.constData() : Q_NULLPTR ) );
+}
+
+void
+Meter::postValue( qreal v )
+{
+	d->postedValue.store( v, std::memory_order_relaxed );
+
+	// While GUI thread polls the slot each frame producers only store
+	// the value, GUI thread is woken by the first value after an idle frame.
+	if( !d->valuePosted.exchange( true ) && !d->draining.load() )
+		QCoreApplication::postEvent( this, new QEvent( MeterPrivate::postedValueEventType() ) );
+}
+
+const QColor &
+Meter::backgroundColor() const
+{
+	return d->settings().backgroundColor;
+}
+
+void
+Meter::setBackgroundColor( const QColor & c )
+{
+	d->editSettings( MeterStyleData::Face | MeterStyleData::Sprites ).backgroundColor = c;
+
+	d->requestUpdate();
+}
+
+const QColor &
+Meter::needleColor() const
+{
+	return d->settings().needleColor;
+}
+
+void
+Meter::setNeedleColor( const QColor & c )
+{
+	d->editSettings( MeterStyleData::Sprites ).needleColor = c;
+
+	d->requestUpdate();
+}
+
+const QColor &
+Meter::textColor() const
+{
+	return d->settings().textColor;
+}
+
+void
+Meter::setTextColor( const QColor & c )
+{
+	// Text color is in the face, glyphs of the value label and the hub.
+	d->editSettings( MeterStyleData::Face | MeterStyleData::Atlas |
+		MeterStyleData::Sprites ).textColor = c;
+
+	d->requestUpdate();
+}
+
+const QColor &
+Meter::gridColor() const
+{
+	return d->settings().gridColor;
+}
+
+void
+Meter::setGridColor( const QColor & c )
+{
+	d->editSettings( MeterStyleData::Face ).gridColor = c;
+
+	d->requestUpdate();
+}
+
+const QString &
+Meter::label() const
+{
+	return d->settings().label;
+}
+
+void
+Meter::setLabel( const QString & l )
+{
+	d->editSettings( MeterStyleData::Text ).label = l;
+
+	d->requestUpdate();
+}
+
+const QString
+Meter::unitsLabel() const
+{
+	return d->settings().unitsLabel;
+}
+
+void
+Meter::setUnitsLabel( const QString & l )
+{
+	d->editSettings( MeterStyleData::Text ).unitsLabel = l;
+
+	d->requestUpdate();
+}
+
+uint
+Meter::radius() const
+{
+	return d->settings().radius;
+}
+
+void
+Meter::setRadius( uint r )
+{
+	if( r < 45 )
+		r = 45;
+
+	d->editSettings( MeterStyleData::AllCaches ).radius = r;
+
+	resize( sizeHint() );
+
+	d->requestUpdate();
+}
+
+uint
+Meter::startScaleAngle()
+{
+	return d->settings().startScaleAngle;
+}
+
+void
+Meter::setStartScaleAngle( uint a )
+{
+	d->editSettings( MeterStyleData::Geometry ).startScaleAngle = a;
+
+	d->requestUpdate();
+}
+
+uint
+Meter::stopScaleAngle() const
+{
+	return d->settings().stopScaleAngle;
+}
+
+void
+Meter::setStopScaleAngle( uint a )
+{
+	d->editSettings( MeterStyleData::Geometry ).stopScaleAngle = a;
+
+	d->requestUpdate();
+}
+
+qreal
+Meter::scaleStep() const
+{
+	return d->settings().scaleStep;
+}
+
+void
+Meter::setScaleStep( qreal s )
+{
+	if( s >= 0.0 )
+	{
+		d->editSettings( MeterStyleData::Grid ).scaleStep = s;
+
+		d->requestUpdate();
+	}
+}
+
+qreal
+Meter::scaleGridStep() const
+{
+	return d->settings().scaleGridStep;
+}
+
+void
+Meter::setScaleGridStep( qreal s )
+{
+	if( s >= 0.0 )
+	{
+		d->editSettings( MeterStyleData::Grid ).scaleGridStep = s;
+
+		d->requestUpdate();
+	}
+}
+
+bool
+Meter::perceptualFilter() const
+{
+	return d->perceptualFilter;
+}
+
+void
+Meter::setPerceptualFilter( bool on )
+{
+	d->perceptualFilter = on;
+
+	if( on )
+		d->shownText = ( d->settings().drawValue ?
+			d->valueText( d->shownValue ) : QString() );
+}
+
+bool
+Meter::needleSprites() const
+{
+	return d->needleSprites;
+}
+
+void
+Meter::setNeedleSprites( bool on )
+{
+	d->needleSprites = on;
+
+	d->requestUpdate();
+}
+
+int
+Meter::needleAngleSteps() const
+{
+	return d->needleAngleSteps;
+}
+
+void
+Meter::setNeedleAngleSteps( int steps )
+{
+	if( steps >= 0 )
+	{
+		d->needleAngleSteps = steps;
+
+		d->requestUpdate();
+	}
+}
+
+bool
+Meter::coalescing() const
+{
+	return d->coalescing;
+}
+
+void
+Meter::setCoalescing( bool on )
+{
+	d->coalescing = on;
+
+	if( !on )
+	{
+		if( d->frameTimer )
+			d->frameTimer->stop();
+
+		if( d->valueDirty )
+		{
+			d->valueDirty = false;
+
+			d->presentValue();
+		}
+	}
+}
+
+int
+Meter::frameRate() const
+{
+	return d->frameRate;
+}
+
+void
+Meter::setFrameRate( int fps )
+{
+	if( fps >= 0 )
+	{
+		d->frameRate = fps;
+
+		if( d->frameTimer && d->frameTimer->isActive() )
+			d->frameTimer->setInterval( d->frameInterval() );
+
+		if( d->drainTimer && d->drainTimer->isActive() )
+			d->drainTimer->setInterval( d->frameInterval() );
+	}
+}
+
+bool
+Meter::valueStatsEnabled() const
+{
+	return !d->valueStats.isNull();
+}
+
+void
+Meter::setValueStatsEnabled( bool on )
+{
+	if( on != valueStatsEnabled() )
+	{
+		if( on )
+		{
+			d->valueStats.reset( new MeterPrivate::ValueStats );
+			d->valueStats->stats.setHalfLife( d->valueStatsHalfLife );
+			d->valueStats->stats.setWindow( d->valueStatsWindow );
+		}
+		else
+			d->valueStats.reset();
+
+		d->requestUpdate();
+	}
+}
+
+const MeterValueStats &
+Meter::valueStats() const
+{
+	static const MeterValueStats c_empty;
+
+	return ( d->valueStats ? d->valueStats->stats : c_empty );
+}
+
+void
+Meter::resetValueStats()
+{
+	if( d->valueStats )
+	{
+		d->valueStats->stats.reset();
+		d->valueStats->drawn = MeterPrivate::StatsBand();
+
+		d->requestUpdate();
+	}
+}
+
+int
+Meter::valueStatsHalfLife() const
+{
+	return d->valueStatsHalfLife;
+}
+
+void
+Meter::setValueStatsHalfLife( int samples )
+{
+	d->valueStatsHalfLife = qMax( 0, samples );
+
+	if( d->valueStats )
+		d->valueStats->stats.setHalfLife( d->valueStatsHalfLife );
+}
+
+int
+Meter::valueStatsWindow() const
+{
+	return d->valueStatsWindow;
+}
+
+void
+Meter::setValueStatsWindow( int samples )
+{
+	d->valueStatsWindow = qMax( 0, samples );
+
+	if( d->valueStats )
+		d->valueStats->stats.setWindow( d->valueStatsWindow );
+}
+
+const QColor &
+Meter::statsBandColor() const
+{
+	return d->settings().statsBandColor;
+}
+
+void
+Meter::setStatsBandColor( const QColor & c )
+{
+	d->editSettings( MeterStyleData::NoCaches ).statsBandColor = c;
+
+	d->requestUpdate();
+}
+
+int
+Meter::historyCapacity() const
+{
+	return d->history.capacity();
+}
+
+void
+Meter::setHistoryCapacity( int samples )
+{
+	if( samples >= 0 && samples != d->history.capacity() )
+		d->history.setCapacity( samples );
+}
+
+const MeterHistory &
+Meter::history() const
+{
+	return d->history;
+}
+
+int
+Meter::trailTime() const
+{
+	return d->trailTime;
+}
+
+void
+Meter::setTrailTime( int ms )
 {
-	if( scaleGridStep > 0.0 && drawGridValues )
+	if( ms >= 0 && ms != d->trailTime )
 	{
-		painter.save();
-		painter.translate( radius, radius );
-		painter.setPen( textColor );
-
-		qreal startRad = - qDegreesToRadians( (qreal) startScaleAngle  );
-		int stepsCount = ( ( maxValue - minValue ) / scaleGridStep );
-		qreal deltaRad = - qDegreesToRadians( params.scaleDegree / stepsCount );
-		qreal sina, cosa;
-		qreal val = minValue;
-
-		QFont f = painter.font();
-		f.setPixelSize( params.fontPixelSize );
-		painter.setFont( f );
-		QFontMetricsF fm( f );
+		d->trailTime = ms;
+		d->trail.clear();
 
-		for ( int i = 0; i <= stepsCount; ++i )
-		{
-			sina = qSin( startRad + i * deltaRad );
-			cosa = qCos( startRad + i * deltaRad );
+		d->requestUpdate();
+	}
+}
 
-			const QString str = QString::number( val, 'f', scalePrecision );
+int
+Meter::extremesWindow() const
+{
+	return d->extremesWindow;
+}
 
-			const QSizeF s = fm.size( Qt::TextSingleLine, str );
+void
+Meter::setExtremesWindow( int ms )
+{
+	if( ms < 0 || ms == d->extremesWindow )
+		return;
 
-			const qreal offset = ( radius - params.gridLabelSize - params.margin * 3 );
+	const bool wasOff = ( d->extremesWindow == 0 );
 
-			const int x = ( offset * sina ) - ( s.width() / 2 );
-			const int y = ( offset * cosa ) + ( s.height() / 4 );
+	d->extremesWindow = ms;
 
-			painter.drawText( x, y, str );
+	if( ms == 0 )
+	{
+		d->extremes.reset();
+		d->requestUpdate();
+	}
+	else if( wasOff )
+	{
+		d->extremes.reset( new MeterPrivate::Extremes );
+		d->extremes->expiryTimer.setSingleShot( true );
 
-			val += scaleGridStep;
-		}
+		connect( &d->extremes->expiryTimer, &QTimer::timeout, this,
+			[this] () { d->expiryTick(); } );
 
-		painter.restore();
+		resetExtremes();
 	}
-
-	if( !unitsLabel.isEmpty() )
+	else
 	{
-		painter.save();
-		QFont f = painter.font();
-		f.setPixelSize( params.fontPixelSize );
-		painter.setFont( f );
-		painter.setPen( textColor );
-		painter.drawText( QRectF( 0, params.margin * 3 + params.gridLabelSize * 3,
-			radius * 2, radius ), unitsLabel, QTextOption( Qt::AlignHCenter ) );
-		painter.restore();
+		d->extremes->expiryTimer.stop();
+		d->expiryTick();
 	}
+}
 
-	if( !label.isEmpty() )
-	{
-		painter.save();
-		QFont f = painter.font();
-		f.setPixelSize( params.fontPixelSize );
-		painter.setFont( f );
-		painter.setPen( textColor );
-		painter.drawText( QRectF( 0, radius * 2 - params.margin * 3 - params.gridLabelSize * 3,
-			radius * 2, radius ), label, QTextOption( Qt::AlignHCenter ) );
-		painter.restore();
-	}
+qreal
+Meter::peakValue() const
+{
+	return d->peak();
+}
 
-	if( drawValue )
-	{
-		painter.save();
-		QFont f = painter.font();
-		f.setPixelSize( params.fontPixelSize * 2 );
-		f.setBold( true );
-		painter.setFont( f );
-		painter.setPen( textColor );
-		painter.drawText( QRectF( 0, radius * 2 - params.margin - params.gridLabelSize * 2,
-			radius * 2, radius ), QString::number( value, 'f', valuePrecision ),
-			QTextOption( Qt::AlignHCenter ) );
-		painter.restore();
-	}
+qreal
+Meter::troughValue() const
+{
+	return d->trough();
 }
 
 void
-MeterPrivate::drawNeedle( QPainter & painter, DrawParams & params )
+Meter::resetExtremes()
 {
-	const qreal r = radius / 10.0;
+	if( d->extremes )
+	{
+		d->extremes->maxSamples.clear();
+		d->extremes->minSamples.clear();
+		d->extremes->expiryTimer.stop();
 
-	painter.save();
-	painter.translate( radius, radius );
-	painter.rotate( params.startScaleAngle + params.scaleDegree * value / ( maxValue - minValue ) );
-	painter.setPen( QPen( needleColor, radius / 75.0 ) );
-	painter.drawLine( 0, radius - params.margin, 0, - ( r * 2.0 ) );
-	painter.setBrush( backgroundColor );
-	painter.setPen( Qt::NoPen );
-	painter.drawEllipse( -r, -r, r * 2.0, r * 2.0 );
-	painter.restore();
+		d->pushExtremes( d->clock.elapsed(), d->value );
+	}
 
-	painter.save();
-	const auto c = backgroundColor.redF() + backgroundColor.greenF() + backgroundColor.blueF();
-	painter.translate( radius, radius );
-	QRadialGradient gradient( 0.0, 0.0, r, r, r );
+	d->requestUpdate();
+}
 
-	if( c < 1.0 )
-	{
-		gradient.setColorAt( 0.0, textColor );
-		gradient.setColorAt( 1.0, Qt::transparent );
-	}
-	else
-	{
-		gradient.setColorAt( 1.0, textColor );
-		gradient.setColorAt( 0.0, Qt::transparent );
-	}
+const QColor &
+Meter::markerColor() const
+{
+	return d->settings().markerColor;
+}
 
-	painter.setBrush( gradient );
-	painter.setPen( Qt::NoPen );
-	painter.drawEllipse( -r, -r, r * 2.0, r * 2.0 );
-	painter.restore();
+void
+Meter::setMarkerColor( const QColor & c )
+{
+	d->editSettings( MeterStyleData::NoCaches ).markerColor = c;
+
+	d->requestUpdate();
 }
 
 bool
-MeterPrivate::thresholdFired()
+Meter::animated() const
 {
-	bool res = false;
+	return d->animated;
+}
 
-	for( auto it = ranges.cbegin(), last = ranges.cend(); it != last; ++it )
-	{
-		if( ( value > it.value().start || qAbs( value - it.value().start ) < 0.000001 ) &&
-			value < it.value().stop )
-		{
-			if( currentThreshold != it.key() )
-				res = true;
+void
+Meter::setAnimated( bool on )
+{
+	if( d->animated == on )
+		return;
 
-			currentThreshold = it.key();
+	d->animated = on;
 
-			break;
-		}
+	if( on )
+	{
+		d->needleValue = d->value;
+		d->needleVelocity = 0.0;
 	}
+	else
+		d->stopAnimation();
 
-	return res;
+	d->requestUpdate();
 }
 
-
-//
-// Meter
-//
-
-Meter::Meter( QWidget * parent )
-	:  QWidget( parent )
-	,  d( new MeterPrivate( this ) )
+int
+Meter::animationTime() const
 {
-	setSizePolicy( QSizePolicy::Fixed, QSizePolicy::Fixed );
+	return d->animationTime;
 }
 
-Meter::~Meter()
+void
+Meter::setAnimationTime( int ms )
 {
+	if( ms > 0 )
+		d->animationTime = ms;
 }
 
 qreal
-Meter::minValue() const
+Meter::animationDamping() const
 {
-	return d->minValue;
+	return d->animationDamping;
 }
 
 void
-Meter::setMinValue( qreal v )
+Meter::setAnimationDamping( qreal r )
 {
-	d->minValue = v;
-
-	if( d->minValue > d->maxValue )
-		d->maxValue = d->minValue;
-
-	update();
+	if( r > 0.0 )
+		d->animationDamping = r;
 }
 
 qreal
-Meter::maxValue() const
+Meter::maxSlewRate() const
 {
-	return d->maxValue;
+	return d->maxSlewRate;
 }
 
 void
-Meter::setMaxValue( qreal v )
+Meter::setMaxSlewRate( qreal r )
 {
-	d->maxValue = v;
-
-	if( d->minValue > d->maxValue )
-		d->minValue = d->maxValue;
-
-	update();
+	if( r >= 0.0 )
+		d->maxSlewRate = r;
 }
 
-qreal
-Meter::value() const
+bool
+Meter::instrumented() const
 {
-	return d->value;
+	return !d->instrumentation.isNull();
 }
 
 void
-Meter::setValue( qreal v )
+Meter::setInstrumented( bool on )
 {
-	if( ( v > d->minValue || qAbs( v - d->minValue ) < 0.000001 ) &&
-		( v < d->maxValue || qAbs( v - d->maxValue ) < 0.000001 ) )
-	{
-		d->value = v;
+	if( on == instrumented() )
+		return;
 
-		update();
+	if( on )
+	{
+		d->instrumentation.reset( new MeterPrivate::Instrumentation );
 
-		emit valueChanged( v );
+		connect( &d->instrumentation->timer, &QTimer::timeout, this,
+			[this] () { emit renderStatsUpdated( d->instrumentation->stats ); } );
 
-		if( d->thresholdFired() )
-			emit thresholdFired( d->currentThreshold );
+		if( d->statsInterval > 0 )
+			d->instrumentation->timer.start( d->statsInterval );
 	}
+	else
+		d->instrumentation.reset();
 }
 
-const QColor &
-Meter::backgroundColor() const
+MeterRenderStats
+Meter::renderStats() const
 {
-	return d->backgroundColor;
+	return ( d->instrumentation ? d->instrumentation->stats : MeterRenderStats() );
 }
 
 void
-Meter::setBackgroundColor( const QColor & c )
+Meter::resetRenderStats()
 {
-	d->backgroundColor = c;
-
-	update();
+	if( d->instrumentation )
+		d->instrumentation->stats = MeterRenderStats();
 }
 
-const QColor &
-Meter::needleColor() const
+int
+Meter::statsInterval() const
 {
-	return d->needleColor;
+	return d->statsInterval;
 }
 
 void
-Meter::setNeedleColor( const QColor & c )
+Meter::setStatsInterval( int ms )
 {
-	d->needleColor = c;
+	if( ms >= 0 )
+	{
+		d->statsInterval = ms;
 
-	update();
+		if( d->instrumentation )
+		{
+			if( ms > 0 )
+				d->instrumentation->timer.start( ms );
+			else
+				d->instrumentation->timer.stop();
+		}
+	}
 }
 
-const QColor &
-Meter::textColor() const
+quint64
+Meter::samplesReceived() const
 {
-	return d->textColor;
+	return d->samplesReceived;
 }
 
-void
-Meter::setTextColor( const QColor & c )
+quint64
+Meter::framesRendered() const
 {
-	d->textColor = c;
+	return d->framesRendered;
+}
 
-	update();
+void
+Meter::resetCounters()
+{
+	d->samplesReceived = 0;
+	d->framesRendered = 0;
 }
 
-const QColor &
-Meter::gridColor() const
+bool
+Meter::drawValue() const
 {
-	return d->gridColor;
+	return d->settings().drawValue;
 }
 
 void
-Meter::setGridColor( const QColor & c )
+Meter::setDrawValue( bool on )
 {
-	d->gridColor = c;
+	d->editSettings( MeterStyleData::NoCaches ).drawValue = on;
 
-	update();
+	d->requestUpdate();
 }
 
-const QString &
-Meter::label() const
+int
+Meter::drawValuePrecision() const
 {
-	return d->label;
+	return d->settings().valuePrecision;
 }
 
 void
-Meter::setLabel( const QString & l )
+Meter::setDrawValuePrecision( int p )
 {
-	d->label = l;
+	if( p >= 0 )
+	{
+		d->editSettings( MeterStyleData::NoCaches ).valuePrecision = p;
 
-	update();
+		d->requestUpdate();
+	}
 }
 
-const QString
-Meter::unitsLabel() const
+int
+Meter::scaleLabelPrecision() const
 {
-	return d->unitsLabel;
+	return d->settings().scalePrecision;
 }
 
 void
-Meter::setUnitsLabel( const QString & l )
+Meter::setScaleLabelPrecision( int p )
 {
-	d->unitsLabel = l;
+	if( p >= 0 )
+	{
+		d->editSettings( MeterStyleData::Text ).scalePrecision = p;
 
-	update();
+		d->requestUpdate();
+	}
 }
 
-uint
-Meter::radius() const
+bool
+Meter::drawGridValues() const
 {
-	return d->radius;
+	return d->settings().drawGridValues;
 }
 
 void
-Meter::setRadius( uint r )
+Meter::setDrawGridValues( bool on )
 {
-	if( r < 45 )
-		r = 45;
+	d->editSettings( MeterStyleData::Text ).drawGridValues = on;
 
-	d->radius = r;
+	d->requestUpdate();
+}
 
-	resize( sizeHint() );
+void
+Meter::setThresholdRange( qreal start, qreal stop, int thresholdIndex,
+	const QColor & color )
+{
+	d->editSettings( MeterStyleData::Bands | MeterStyleData::Face ).ranges.insert(
+		thresholdIndex, { start, stop, color } );
 
-	update();
+	d->thresholdsChanged();
+	d->requestUpdate();
 }
 
-uint
-Meter::startScaleAngle()
+void
+Meter::setThresholdRanges( const QMultiMap< int, MeterRange > & ranges )
 {
-	return d->startScaleAngle;
+	d->editSettings( MeterStyleData::Bands | MeterStyleData::Face ).ranges = ranges;
+
+	d->thresholdsChanged();
+	d->requestUpdate();
 }
 
 void
-Meter::setStartScaleAngle( uint a )
+Meter::clearThresholdRanges()
 {
-	d->startScaleAngle = a;
+	if( !d->settings().ranges.isEmpty() )
+	{
+		d->editSettings( MeterStyleData::Bands | MeterStyleData::Face ).ranges.clear();
 
-	update();
+		d->thresholdsChanged();
+		d->requestUpdate();
+	}
 }
 
-uint
-Meter::stopScaleAngle() const
+const QMultiMap< int, MeterRange > &
+Meter::thresholdRanges() const
 {
-	return d->stopScaleAngle;
+	return d->settings().ranges;
 }
 
-void
-Meter::setStopScaleAngle( uint a )
+int
+Meter::needleCount() const
 {
-	d->stopScaleAngle = a;
-
-	update();
+	return d->needles.size() + 1;
 }
 
-qreal
-Meter::scaleStep() const
+int
+Meter::addNeedle( const QColor & color )
 {
-	return d->scaleStep;
+	MeterPrivate::Needle n;
+	n.value = d->settings().minValue;
+	n.color = color;
+
+	d->needles.append( n );
+
+	d->requestUpdate();
+
+	return d->needles.size();
 }
 
 void
-Meter::setScaleStep( qreal s )
+Meter::removeNeedle( int index )
 {
-	if( s >= 0.0 )
+	if( d->isAdditionalNeedle( index ) )
 	{
-		d->scaleStep = s;
+		d->needles.remove( index - 1 );
 
-		update();
+		d->requestUpdate();
 	}
 }
 
 qreal
-Meter::scaleGridStep() const
+Meter::needleValue( int index ) const
 {
-	return d->scaleGridStep;
+	if( d->isAdditionalNeedle( index ) )
+		return d->needle( index ).value;
+	else
+		return value();
 }
 
 void
-Meter::setScaleGridStep( qreal s )
+Meter::setNeedleValue( int index, qreal v )
 {
-	if( s >= 0.0 )
+	if( index == 0 )
+		setValue( v );
+	else if( d->isAdditionalNeedle( index ) && d->isInRange( v ) )
 	{
-		d->scaleGridStep = s;
+		MeterPrivate::Needle & n = d->needle( index );
+		const qreal old = n.value;
+
+		n.value = v;
+
+		d->needleMoved( n, old );
+
+		emit needleValueChanged( index, v );
 
-		update();
+		if( d->needleThresholdFired( n ) )
+			emit needleThresholdFired( index, n.currentThreshold );
 	}
 }
 
-bool
-Meter::drawValue() const
+QColor
+Meter::needleColor( int index ) const
 {
-	return d->drawValue;
+	if( d->isAdditionalNeedle( index ) )
+		return d->needle( index ).color;
+	else
+		return needleColor();
 }
 
 void
-Meter::setDrawValue( bool on )
+Meter::setNeedleColor( int index, const QColor & c )
 {
-	d->drawValue = on;
+	if( index == 0 )
+		setNeedleColor( c );
+	else if( d->isAdditionalNeedle( index ) )
+	{
+		d->needle( index ).color = c;
 
-	update();
+		d->requestUpdate();
+	}
 }
 
-int
-Meter::drawValuePrecision() const
+QMultiMap< int, MeterRange >
+Meter::needleThresholdRanges( int index ) const
 {
-	return d->valuePrecision;
+	if( d->isAdditionalNeedle( index ) )
+		return d->needle( index ).ranges;
+	else
+		return thresholdRanges();
 }
 
 void
-Meter::setDrawValuePrecision( int p )
+Meter::setNeedleThresholdRanges( int index, const QMultiMap< int, MeterRange > & ranges )
 {
-	if( p >= 0 )
+	if( index == 0 )
+		setThresholdRanges( ranges );
+	else if( d->isAdditionalNeedle( index ) )
 	{
-		d->valuePrecision = p;
+		MeterPrivate::Needle & n = d->needle( index );
+
+		n.ranges = ranges;
+		n.bands.rebuild( ranges );
+		n.currentBand = -1;
 
-		update();
+		if( d->needleThresholdFired( n ) )
+			emit needleThresholdFired( index, n.currentThreshold );
 	}
 }
 
-int
-Meter::scaleLabelPrecision() const
+void
+Meter::beginUpdate()
 {
-	return d->scalePrecision;
+	++d->updateDepth;
 }
 
 void
-Meter::setScaleLabelPrecision( int p )
+Meter::endUpdate()
 {
-	if( p >= 0 )
+	if( d->updateDepth == 0 || --d->updateDepth > 0 )
+		return;
+
+	if( d->thresholdsPending )
+	{
+		d->thresholdsPending = false;
+
+		d->thresholdsChanged();
+	}
+
+	if( d->updatePending )
 	{
-		d->scalePrecision = p;
+		d->updatePending = false;
 
-		update();
+		d->requestUpdate();
 	}
 }
 
-bool
-Meter::drawGridValues() const
+qreal
+Meter::thresholdHysteresis() const
 {
-	return d->drawGridValues;
+	return d->thresholdHysteresis;
 }
 
 void
-Meter::setDrawGridValues( bool on )
+Meter::setThresholdHysteresis( qreal h )
 {
-	d->drawGridValues = on;
+	if( h >= 0.0 )
+		d->thresholdHysteresis = h;
+}
 
-	update();
+int
+Meter::thresholdDwellTime() const
+{
+	return d->thresholdDwellTime;
 }
 
 void
-Meter::setThresholdRange( qreal start, qreal stop, int thresholdIndex,
-	const QColor & color )
+Meter::setThresholdDwellTime( int ms )
+{
+	if( ms >= 0 )
+		d->thresholdDwellTime = ms;
+}
+
+MeterSnapshot
+Meter::snapshot() const
+{
+	return MeterSnapshot( d->settings(), d->value );
+}
+
+const MeterStyle &
+Meter::meterStyle() const
+{
+	return d->style;
+}
+
+void
+Meter::setMeterStyle( const MeterStyle & s )
 {
-	d->ranges.insert( thresholdIndex, { start, stop, color } );
+	const bool resized = ( s.settings().radius != d->settings().radius );
+
+	d->style = s;
+
+	if( d->perceptualFilter )
+		d->shownText = ( d->settings().drawValue ?
+			d->valueText( d->shownValue ) : QString() );
+
+	if( resized )
+	{
+		updateGeometry();
 
-	if( d->thresholdFired() )
-		emit thresholdFired( d->currentThreshold );
+		resize( sizeHint() );
+	}
 
-	update();
+	d->thresholdsChanged();
+	d->requestUpdate();
 }
 
 QSize
 Meter::minimumSizeHint() const
 {
-	return QSize( d->radius * 2 + 2, d->radius * 2 + 2 );
+	return QSize( d->settings().radius * 2 + 2, d->settings().radius * 2 + 2 );
 }
 
 QSize
@@ -693,15 +2676,64 @@ Meter::sizeHint() const
 void
 Meter::paintEvent( QPaintEvent * )
 {
-	QPainter p( this );
-	p.setRenderHint( QPainter::Antialiasing );
-	p.translate( 1.0, 1.0 );
+	++d->framesRendered;
+	d->exposed = true;
 
-	MeterPrivate::DrawParams params;
+	d->paint( d->instrumentation ? &d->instrumentation->stats : Q_NULLPTR );
+}
+
+void
+Meter::customEvent( QEvent * e )
+{
+	if( e->type() == MeterPrivate::postedValueEventType() )
+		d->drainPostedValue();
+	else
+		QWidget::customEvent( e );
+}
+
+void
+Meter::showEvent( QShowEvent * e )
+{
+	d->watchWindow();
+	d->updateVisibility();
+
+	QWidget::showEvent( e );
+}
+
+void
+Meter::hideEvent( QHideEvent * e )
+{
+	d->updateVisibility();
+
+	QWidget::hideEvent( e );
+}
+
+void
+Meter::moveEvent( QMoveEvent * e )
+{
+	d->updateVisibility();
+
+	QWidget::moveEvent( e );
+}
+
+void
+Meter::resizeEvent( QResizeEvent * e )
+{
+	d->updateVisibility();
+
+	QWidget::resizeEvent( e );
+}
+
+void
+Meter::changeEvent( QEvent * e )
+{
+	// Style is detached only if the font really differs.
+	if( e->type() == QEvent::FontChange && d->settings().font != font() )
+	{
+		d->editSettings( MeterStyleData::Text | MeterStyleData::Atlas ).font = font();
+
+		d->requestUpdate();
+	}
 
-	d->drawBackground( p, params );
-	d->drawRanges( p, params );
-	d->drawScale( p, params );
-	d->drawLabels( p, params );
-	d->drawNeedle( p, params );
+	QWidget::changeEvent( e );
 }
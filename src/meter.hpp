@@ -34,6 +34,29 @@
 // Qt include.
 #include <QWidget>
 #include <QScopedPointer>
+#include <QVector>
+
+// Widgets include.
+#include "meter_renderer.hpp"
+#include "meter_style.hpp"
+#include "meter_history.hpp"
+#include "meter_stats.hpp"
+
+
+//
+// MeterCrossing
+//
+
+//! Transition of the meter to another threshold in a batch of samples.
+struct MeterCrossing {
+	//! Index of the sample in the batch.
+	int sampleIndex;
+	//! Timestamp of the sample or -1 if the batch has no timestamps.
+	qint64 timestamp;
+	int thresholdIndex;
+}; // struct MeterCrossing
+
+Q_DECLARE_TYPEINFO( MeterCrossing, Q_PRIMITIVE_TYPE );
 
 
 //
@@ -66,12 +89,39 @@ class Meter Q_DECL_FINAL
 	Q_PROPERTY( bool drawGridValues READ drawGridValues WRITE setDrawGridValues )
 	Q_PROPERTY( int drawValuePrecision READ drawValuePrecision WRITE setDrawValuePrecision )
 	Q_PROPERTY( int scaleLabelPrecision READ scaleLabelPrecision WRITE setScaleLabelPrecision )
+	Q_PROPERTY( bool perceptualFilter READ perceptualFilter WRITE setPerceptualFilter )
+	Q_PROPERTY( bool needleSprites READ needleSprites WRITE setNeedleSprites )
+	Q_PROPERTY( int needleAngleSteps READ needleAngleSteps WRITE setNeedleAngleSteps )
+	Q_PROPERTY( bool coalescing READ coalescing WRITE setCoalescing )
+	Q_PROPERTY( int frameRate READ frameRate WRITE setFrameRate )
+	Q_PROPERTY( qreal thresholdHysteresis READ thresholdHysteresis WRITE setThresholdHysteresis )
+	Q_PROPERTY( int thresholdDwellTime READ thresholdDwellTime WRITE setThresholdDwellTime )
+	Q_PROPERTY( bool valueStatsEnabled READ valueStatsEnabled WRITE setValueStatsEnabled )
+	Q_PROPERTY( int valueStatsHalfLife READ valueStatsHalfLife WRITE setValueStatsHalfLife )
+	Q_PROPERTY( int valueStatsWindow READ valueStatsWindow WRITE setValueStatsWindow )
+	Q_PROPERTY( QColor statsBandColor READ statsBandColor WRITE setStatsBandColor )
+	Q_PROPERTY( int historyCapacity READ historyCapacity WRITE setHistoryCapacity )
+	Q_PROPERTY( int trailTime READ trailTime WRITE setTrailTime )
+	Q_PROPERTY( int extremesWindow READ extremesWindow WRITE setExtremesWindow )
+	Q_PROPERTY( QColor markerColor READ markerColor WRITE setMarkerColor )
+	Q_PROPERTY( bool animated READ animated WRITE setAnimated )
+	Q_PROPERTY( int animationTime READ animationTime WRITE setAnimationTime )
+	Q_PROPERTY( qreal animationDamping READ animationDamping WRITE setAnimationDamping )
+	Q_PROPERTY( qreal maxSlewRate READ maxSlewRate WRITE setMaxSlewRate )
+	Q_PROPERTY( bool instrumented READ instrumented WRITE setInstrumented )
+	Q_PROPERTY( int statsInterval READ statsInterval WRITE setStatsInterval )
 
 signals:
 	//! Value changed.
 	void valueChanged( qreal currentValue );
 	//! Threshold.
 	void thresholdFired( int thresholdIndex );
+	//! Value of the needle changed, emitted for every needle including 0.
+	void needleValueChanged( int needleIndex, qreal currentValue );
+	//! Needle entered the threshold, emitted for every needle including 0.
+	void needleThresholdFired( int needleIndex, int thresholdIndex );
+	//! Periodic render statistics when instrumentation is on.
+	void renderStatsUpdated( const MeterRenderStats & stats );
 
 public:
 	Meter( QWidget * parent = Q_NULLPTR );
@@ -83,6 +133,11 @@ public:
 	qreal maxValue() const;
 	void setMaxValue( qreal v );
 
+	//! \return Mapping of values to the arc of the scale.
+	const MeterScale & scale() const;
+	//! Set mapping of values to the arc, used by the scale, ranges and needle.
+	void setScale( const MeterScale & s );
+
 	qreal value() const;
 
 	const QColor & backgroundColor() const;
@@ -118,6 +173,168 @@ public:
 	qreal scaleGridStep() const;
 	void setScaleGridStep( qreal s );
 
+	bool perceptualFilter() const;
+	/*!
+		\brief Enable or disable perceptual change filter.
+
+		When enabled a new value that moves the needle by less than a
+		pixel and doesn't change the text of the value label neither
+		repaints the meter nor emits valueChanged(). value() and
+		thresholds stay exact.
+	*/
+	void setPerceptualFilter( bool on = true );
+
+	bool needleSprites() const;
+	/*!
+		\brief Enable or disable pre-rendered needle.
+
+		Hub of the needle is rendered once and the needle is rendered
+		once per quantized angle, that is cheap on the software raster
+		engine. Sprites are rebuilt when colors, radius or device pixel
+		ratio change.
+	*/
+	void setNeedleSprites( bool on = true );
+
+	int needleAngleSteps() const;
+	/*!
+		\brief Set count of needle angles per full turn for sprites.
+
+		More steps give smoother needle at the cost of memory,
+		0 means the needle is not quantized and is drawn as is,
+		only the hub is pre-rendered.
+	*/
+	void setNeedleAngleSteps( int steps );
+
+	bool coalescing() const;
+	/*!
+		\brief Enable or disable coalescing of values.
+
+		In coalescing mode setValue() only stores the value, the meter is
+		repainted and valueChanged() is emitted at most once per frame
+		with the latest value. Thresholds are checked on each value.
+	*/
+	void setCoalescing( bool on = true );
+
+	int frameRate() const;
+	//! Set frames per second for coalescing mode, 0 means refresh rate of the screen.
+	void setFrameRate( int fps );
+
+	bool valueStatsEnabled() const;
+	/*!
+		\brief Enable or disable statistics of values.
+
+		When on every accepted value updates mean, standard deviation,
+		p95 and p99 in constant time and memory, and a band from
+		mean - sd to mean + sd with ticks at p95 and p99 is drawn on
+		the scale. Turning statistics on or off resets them.
+	*/
+	void setValueStatsEnabled( bool on = true );
+	//! \return Statistics of values since enabled or reset, empty while they are off.
+	const MeterValueStats & valueStats() const;
+	void resetValueStats();
+
+	int valueStatsHalfLife() const;
+	//! Set half-life of mean and deviation in samples, 0 means no decay.
+	void setValueStatsHalfLife( int samples );
+
+	int valueStatsWindow() const;
+	//! Set count of samples after which statistics reset, 0 means never.
+	void setValueStatsWindow( int samples );
+
+	const QColor & statsBandColor() const;
+	void setStatsBandColor( const QColor & c );
+
+	int historyCapacity() const;
+	/*!
+		\brief Set capacity of history of values in samples.
+
+		History is preallocated, 0 turns it off. Setting capacity drops
+		all samples.
+	*/
+	void setHistoryCapacity( int samples );
+	//! \return History of accepted values, the oldest first.
+	const MeterHistory & history() const;
+
+	int trailTime() const;
+	/*!
+		\brief Set time span of the trail in milliseconds.
+
+		Trail is a sparkline of recent values inside the dial, values are
+		decimated to min and max per pixel column as they come, so paint
+		cost depends on width of the trail only. 0 turns trail off. Trail
+		is restored from history when its geometry changes.
+	*/
+	void setTrailTime( int ms );
+
+	int extremesWindow() const;
+	/*!
+		\brief Set time window of peak and trough markers in milliseconds.
+
+		Markers on the scale show maximum and minimum of values set
+		within the window, 0 turns markers off. Extremes are tracked
+		with monotonic queues, so each value costs amortized O(1).
+	*/
+	void setExtremesWindow( int ms );
+
+	//! \return Maximum value within the window.
+	qreal peakValue() const;
+	//! \return Minimum value within the window.
+	qreal troughValue() const;
+	//! Restart tracking of extremes from the current value.
+	void resetExtremes();
+
+	const QColor & markerColor() const;
+	void setMarkerColor( const QColor & c );
+
+	bool animated() const;
+	/*!
+		\brief Enable or disable animation of the needle.
+
+		Needle moves to the value as a damped spring driven by the frame
+		clock shared by all meters, the clock ticks only while any needle
+		moves. value(), the value label and thresholds use the target
+		value at once.
+	*/
+	void setAnimated( bool on = true );
+
+	int animationTime() const;
+	//! Set approximate settle time of the needle in milliseconds.
+	void setAnimationTime( int ms );
+
+	qreal animationDamping() const;
+	//! Set damping ratio of the needle, 1 is critical damping, less overshoots.
+	void setAnimationDamping( qreal r );
+
+	qreal maxSlewRate() const;
+	//! Set maximum speed of the needle in value units per second, 0 is unlimited.
+	void setMaxSlewRate( qreal r );
+
+	bool instrumented() const;
+	/*!
+		\brief Enable or disable render instrumentation.
+
+		When on paints are timed per layer and counted with samples,
+		coalesced samples, skipped updates and threshold signals.
+		Statistics are allocated only when instrumentation is on and
+		are dropped when it's turned off.
+	*/
+	void setInstrumented( bool on = true );
+
+	//! \return Render statistics since instrumentation is on or reset.
+	MeterRenderStats renderStats() const;
+	void resetRenderStats();
+
+	int statsInterval() const;
+	//! Set interval of renderStatsUpdated() in milliseconds, 0 means never.
+	void setStatsInterval( int ms );
+
+	//! \return Count of values accepted by setValue().
+	quint64 samplesReceived() const;
+	//! \return Count of painted frames.
+	quint64 framesRendered() const;
+	//! Reset samples and frames counters.
+	void resetCounters();
+
 	bool drawValue() const;
 	void setDrawValue( bool on = true );
 
@@ -140,15 +357,130 @@ public:
 	*/
 	void setThresholdRange( qreal start, qreal stop, int thresholdIndex,
 		const QColor & color = Qt::transparent );
+	//! Replace all threshold ranges, ranges are keyed by threshold index.
+	void setThresholdRanges( const QMultiMap< int, MeterRange > & ranges );
+	//! Remove all threshold ranges.
+	void clearThresholdRanges();
+	//! \return Threshold ranges by threshold index.
+	const QMultiMap< int, MeterRange > & thresholdRanges() const;
+
+	//! \return Count of needles, the meter's own needle is 0 and always exists.
+	int needleCount() const;
+	/*!
+		\brief Add needle drawn over the same face.
+
+		Needle starts at the minimum value, it has its own value, color
+		and threshold ranges, only the needle that moved is repainted.
+		Ranges of additional needles aren't drawn on the scale and fire
+		without dwell time.
+
+		\return Index of the needle.
+	*/
+	int addNeedle( const QColor & color );
+	//! Remove additional needle, indices of next needles shift down.
+	void removeNeedle( int index );
+	qreal needleValue( int index ) const;
+	//! Set value of the needle, 0 is the same as setValue().
+	void setNeedleValue( int index, qreal v );
+	QColor needleColor( int index ) const;
+	void setNeedleColor( int index, const QColor & c );
+	QMultiMap< int, MeterRange > needleThresholdRanges( int index ) const;
+	void setNeedleThresholdRanges( int index,
+		const QMultiMap< int, MeterRange > & ranges );
+
+	/*!
+		\brief Begin transaction of configuration changes.
+
+		Repaints and threshold checks are deferred till the matching
+		endUpdate(), transactions may be nested. Caches are rebuilt
+		lazily on the next paint anyway.
+	*/
+	void beginUpdate();
+	//! End transaction, repaint and re-check thresholds once if needed.
+	void endUpdate();
+
+	qreal thresholdHysteresis() const;
+	/*!
+		\brief Set hysteresis of thresholds.
+
+		Value should go beyond the range of the current threshold
+		by this amount to leave it.
+	*/
+	void setThresholdHysteresis( qreal h );
+
+	int thresholdDwellTime() const;
+	/*!
+		\brief Set minimum time in milliseconds to stay in the threshold.
+
+		Next threshold fires not earlier than the current one has
+		been kept for this time.
+	*/
+	void setThresholdDwellTime( int ms );
+
+	//! \return Settings and value of the meter for MeterRenderer.
+	MeterSnapshot snapshot() const;
+
+	//! \return Implicitly shared style of the meter.
+	const MeterStyle & meterStyle() const;
+	/*!
+		\brief Set style of the meter.
+
+		Meters with the same style share rendered face, ticks, labels
+		and needle sprites. Any setter of the look detaches the style
+		of this meter.
+	*/
+	void setMeterStyle( const MeterStyle & s );
 
 	QSize minimumSizeHint() const Q_DECL_OVERRIDE;
 	QSize sizeHint() const Q_DECL_OVERRIDE;
 
+	/*!
+		\brief Set a batch of samples.
+
+		Every sample is checked against threshold ranges in order, each
+		transition fires thresholdFired() once, samples out of range are
+		ignored. The meter is repainted and valueChanged() is emitted
+		once with the last accepted sample.
+
+		\param values Samples.
+		\param count Count of samples.
+		\param timestamps Timestamps of samples in milliseconds, reported
+			with crossings. The last sample is taken as now, history, trail
+			and dwell time use timestamps moved to the meter's clock.
+
+		\return Threshold transitions in order of samples.
+	*/
+	QVector< MeterCrossing > setValues( const qreal * values, int count,
+		const qint64 * timestamps = Q_NULLPTR );
+	//! Set a batch of samples, timestamps are used if there is one per sample.
+	QVector< MeterCrossing > setValues( const QVector< qreal > & values,
+		const QVector< qint64 > & timestamps = QVector< qint64 > () );
+
 	public slots:
 	void setValue( qreal v );
 
+	/*!
+		\brief Post value from any thread.
+
+		Thread-safe and lock-free. The value is stored into an atomic
+		slot and applied with setValue() in GUI thread, only the latest
+		posted value is applied, so thresholds are checked against
+		applied values only. While values keep coming GUI thread polls
+		the slot each frame and posting doesn't lock or allocate, only
+		the first value after an idle frame posts an event to wake GUI
+		thread. The meter must outlive producers.
+	*/
+	void postValue( qreal v );
+
 	protected:
 	void paintEvent( QPaintEvent * ) Q_DECL_OVERRIDE;
+	void changeEvent( QEvent * e ) Q_DECL_OVERRIDE;
+	void customEvent( QEvent * e ) Q_DECL_OVERRIDE;
+	//! Painting is skipped while the meter is hidden, covered or its window is minimized.
+	void showEvent( QShowEvent * e ) Q_DECL_OVERRIDE;
+	void hideEvent( QHideEvent * e ) Q_DECL_OVERRIDE;
+	void moveEvent( QMoveEvent * e ) Q_DECL_OVERRIDE;
+	void resizeEvent( QResizeEvent * e ) Q_DECL_OVERRIDE;
 
 private:
 	Q_DISABLE_COPY( Meter )
@@ -156,4 +488,29 @@ private:
 	QScopedPointer< MeterPrivate > d;
 }; // class Meter
 
+
+//
+// MeterUpdateGuard
+//
+
+//! Calls Meter::beginUpdate() on construction and Meter::endUpdate() on destruction.
+class MeterUpdateGuard Q_DECL_FINAL {
+public:
+	explicit MeterUpdateGuard( Meter * meter )
+		:  m_meter( meter )
+	{
+		m_meter->beginUpdate();
+	}
+
+	~MeterUpdateGuard()
+	{
+		m_meter->endUpdate();
+	}
+
+private:
+	Q_DISABLE_COPY( MeterUpdateGuard )
+
+	Meter * m_meter;
+}; // class MeterUpdateGuard
+
 #endif // METER_HPP_INCLUDED
@@ -0,0 +1,404 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_bank.hpp"
+#include "meter_style_p.hpp"
+
+// Qt include.
+#include <QPair>
+
+// C++ include.
+#include <algorithm>
+#include <limits>
+
+
+//
+// MeterBankPrivate
+//
+
+class MeterBankPrivate {
+public:
+	MeterBankPrivate()
+	{
+	}
+
+	//! Append meter with the style.
+	void append( const MeterStyle & style );
+	//! Init range and angle transform of the meter from its style.
+	void initMeter( int i );
+	//! Rebuild flattened bands of all meters.
+	void rebuildBands();
+	//! \return Band of the meter containing the value or -1.
+	int findBand( int i, qreal v ) const;
+	//! Find band of the meter's value. \return Is threshold changed.
+	bool thresholdFired( int i );
+	//! Set current band of the meter and its interval.
+	void setBand( int i, int band );
+
+	//! State of the meter after setValues().
+	enum ChangeState {
+		Unchanged = 0,
+		//! Value changed within the current band.
+		Changed = 1,
+		//! Value changed and left the current band.
+		LeftBand = 2
+	}; // enum ChangeState
+
+	QVector< MeterStyle > styles;
+
+	// Per meter data, i-th element belongs to i-th meter.
+	QVector< qreal > minValues;
+	QVector< qreal > maxValues;
+	QVector< qreal > values;
+	QVector< qreal > angles;
+	/*!
+		Needle angle is angleOffsets[ i ] + values[ i ] * angleScales[ i ]
+		for linear scale, for other scales values are replaced with
+		fractions of the arc from scaleTables[ i ].
+	*/
+	QVector< qreal > angleOffsets;
+	QVector< qreal > angleScales;
+	QVector< MeterScaleTable > scaleTables;
+	//! Meters with non-linear scales, sorted.
+	QVector< int > nonLinearMeters;
+	//! Current band in flattened bands or -1.
+	QVector< int > bands;
+	//! Interval of the current band, empty if there is no band.
+	QVector< qreal > currentStarts;
+	QVector< qreal > currentStops;
+	QVector< int > thresholds;
+	//! First band of the meter in flattened bands.
+	QVector< int > firstBands;
+	QVector< int > bandCounts;
+	//! One of ChangeState per meter.
+	QVector< uchar > changed;
+
+	// Sorted non-overlapping bands of all meters one after another.
+	QVector< qreal > bandStarts;
+	QVector< qreal > bandStops;
+	QVector< int > bandThresholds;
+
+	QVector< int > changedMeters;
+}; // class MeterBankPrivate
+
+void
+MeterBankPrivate::append( const MeterStyle & style )
+{
+	styles.append( style );
+	minValues.append( style.settings().minValue );
+	maxValues.append( style.settings().maxValue );
+	values.append( style.settings().minValue );
+	angles.append( 0.0 );
+	angleOffsets.append( 0.0 );
+	angleScales.append( 0.0 );
+	scaleTables.append( MeterScaleTable() );
+	bands.append( -1 );
+	currentStarts.append( std::numeric_limits< qreal >::infinity() );
+	currentStops.append( -std::numeric_limits< qreal >::infinity() );
+	thresholds.append( 0 );
+	changed.append( 0 );
+
+	const MeterThresholdIndex & index = MeterStyleData::get( style )->bands();
+
+	firstBands.append( bandStarts.size() );
+	bandCounts.append( index.size() );
+
+	for( int i = 0; i < index.size(); ++i )
+	{
+		bandStarts.append( index.at( i ).start );
+		bandStops.append( index.at( i ).stop );
+		bandThresholds.append( index.at( i ).thresholdIndex );
+	}
+
+	initMeter( styles.size() - 1 );
+}
+
+void
+MeterBankPrivate::initMeter( int i )
+{
+	const MeterSettings & s = styles.at( i ).settings();
+	const qreal range = s.maxValue - s.minValue;
+	const qreal degree = qreal( s.stopScaleAngle ) - qreal( s.startScaleAngle );
+
+	minValues[ i ] = s.minValue;
+	maxValues[ i ] = s.maxValue;
+	scaleTables[ i ] = MeterScaleTable( s.scale, s.minValue, s.maxValue );
+
+	const auto it = std::lower_bound( nonLinearMeters.begin(), nonLinearMeters.end(), i );
+	const bool listed = ( it != nonLinearMeters.end() && *it == i );
+
+	if( scaleTables.at( i ).type() == MeterScale::Linear )
+	{
+		if( listed )
+			nonLinearMeters.erase( it );
+
+		angleScales[ i ] = ( range > 0.0 ? degree / range : 0.0 );
+		angleOffsets[ i ] = s.startScaleAngle - s.minValue * angleScales.at( i );
+		angles[ i ] = angleOffsets.at( i ) + values.at( i ) * angleScales.at( i );
+	}
+	else
+	{
+		if( !listed )
+			nonLinearMeters.insert( it, i );
+
+		angleScales[ i ] = degree;
+		angleOffsets[ i ] = s.startScaleAngle;
+		angles[ i ] = angleOffsets.at( i ) +
+			scaleTables.at( i ).fraction( values.at( i ) ) * angleScales.at( i );
+	}
+}
+
+void
+MeterBankPrivate::rebuildBands()
+{
+	bandStarts.clear();
+	bandStops.clear();
+	bandThresholds.clear();
+
+	for( int i = 0; i < styles.size(); ++i )
+	{
+		const MeterThresholdIndex & index = MeterStyleData::get( styles.at( i ) )->bands();
+
+		firstBands[ i ] = bandStarts.size();
+		bandCounts[ i ] = index.size();
+
+		for( int j = 0; j < index.size(); ++j )
+		{
+			bandStarts.append( index.at( j ).start );
+			bandStops.append( index.at( j ).stop );
+			bandThresholds.append( index.at( j ).thresholdIndex );
+		}
+	}
+
+	for( int i = 0; i < styles.size(); ++i )
+		setBand( i, findBand( i, values.at( i ) ) );
+}
+
+int
+MeterBankPrivate::findBand( int i, qreal v ) const
+{
+	const qreal * starts = bandStarts.constData();
+	const qreal * first = starts + firstBands.at( i );
+	const qreal * last = first + bandCounts.at( i );
+	const qreal * it = std::upper_bound( first, last, v );
+
+	if( it == first )
+		return -1;
+
+	const int band = static_cast< int > ( it - 1 - starts );
+
+	return ( v < bandStops.at( band ) ? band : -1 );
+}
+
+bool
+MeterBankPrivate::thresholdFired( int i )
+{
+	const int band = findBand( i, values.at( i ) );
+
+	setBand( i, band );
+
+	if( band >= 0 && bandThresholds.at( band ) != thresholds.at( i ) )
+	{
+		thresholds[ i ] = bandThresholds.at( band );
+
+		return true;
+	}
+
+	return false;
+}
+
+void
+MeterBankPrivate::setBand( int i, int band )
+{
+	bands[ i ] = band;
+
+	if( band >= 0 )
+	{
+		currentStarts[ i ] = bandStarts.at( band );
+		currentStops[ i ] = bandStops.at( band );
+	}
+	else
+	{
+		currentStarts[ i ] = std::numeric_limits< qreal >::infinity();
+		currentStops[ i ] = -std::numeric_limits< qreal >::infinity();
+	}
+}
+
+
+//
+// MeterBank
+//
+
+MeterBank::MeterBank( QObject * parent )
+	:  QObject( parent )
+	,  d( new MeterBankPrivate )
+{
+}
+
+MeterBank::~MeterBank()
+{
+}
+
+int
+MeterBank::addMeter( const MeterStyle & style )
+{
+	d->append( style );
+
+	const int index = d->styles.size() - 1;
+
+	if( d->thresholdFired( index ) )
+		emit thresholdFired( index, d->thresholds.at( index ) );
+
+	return index;
+}
+
+int
+MeterBank::count() const
+{
+	return d->styles.size();
+}
+
+const MeterStyle &
+MeterBank::meterStyle( int meterIndex ) const
+{
+	return d->styles.at( meterIndex );
+}
+
+void
+MeterBank::setMeterStyle( int meterIndex, const MeterStyle & s )
+{
+	if( meterIndex >= 0 && meterIndex < d->styles.size() )
+	{
+		d->styles[ meterIndex ] = s;
+		d->initMeter( meterIndex );
+		d->rebuildBands();
+
+		if( d->thresholdFired( meterIndex ) )
+			emit thresholdFired( meterIndex, d->thresholds.at( meterIndex ) );
+	}
+}
+
+qreal
+MeterBank::value( int meterIndex ) const
+{
+	return d->values.at( meterIndex );
+}
+
+qreal
+MeterBank::angle( int meterIndex ) const
+{
+	return d->angles.at( meterIndex );
+}
+
+int
+MeterBank::currentThreshold( int meterIndex ) const
+{
+	return d->thresholds.at( meterIndex );
+}
+
+MeterSnapshot
+MeterBank::snapshot( int meterIndex ) const
+{
+	return MeterSnapshot( d->styles.at( meterIndex ).settings(), d->values.at( meterIndex ) );
+}
+
+const QVector< int > &
+MeterBank::changedMeters() const
+{
+	return d->changedMeters;
+}
+
+void
+MeterBank::setValues( const qreal * newValues, size_t count )
+{
+	static const qreal c_epsilon = 0.000001;
+
+	const int n = static_cast< int > ( qMin( count,
+		static_cast< size_t > ( d->values.size() ) ) );
+
+	const qreal * minValues = d->minValues.constData();
+	const qreal * maxValues = d->maxValues.constData();
+	const qreal * offsets = d->angleOffsets.constData();
+	const qreal * scales = d->angleScales.constData();
+	const qreal * starts = d->currentStarts.constData();
+	const qreal * stops = d->currentStops.constData();
+	qreal * values = d->values.data();
+	qreal * angles = d->angles.data();
+	uchar * changed = d->changed.data();
+
+	// Range check, change detection, angles and check of the current band
+	// without branches, so the loop is vectorized by compiler.
+	for( int i = 0; i < n; ++i )
+	{
+		const qreal v = newValues[ i ];
+		const bool accepted = ( v >= minValues[ i ] - c_epsilon ) &
+			( v <= maxValues[ i ] + c_epsilon );
+		const bool c = accepted & ( v != values[ i ] );
+
+		values[ i ] = ( c ? v : values[ i ] );
+		angles[ i ] = offsets[ i ] + values[ i ] * scales[ i ];
+
+		const bool inBand = ( values[ i ] >= starts[ i ] ) & ( values[ i ] < stops[ i ] );
+
+		changed[ i ] = static_cast< uchar > ( c ) + static_cast< uchar > ( c & !inBand );
+	}
+
+	// Non-linear scales are mapped with their tables after the linear pass.
+	for( const int i : qAsConst( d->nonLinearMeters ) )
+	{
+		if( i >= n )
+			break;
+
+		angles[ i ] = offsets[ i ] + d->scaleTables.at( i ).fraction( values[ i ] ) * scales[ i ];
+	}
+
+	d->changedMeters.clear();
+
+	QVector< QPair< int, int > > fired;
+
+	// Binary search of bands depends on data, so it's done apart only
+	// for meters that left their band.
+	for( int i = 0; i < n; ++i )
+	{
+		if( changed[ i ] == MeterBankPrivate::Unchanged )
+			continue;
+
+		d->changedMeters.append( i );
+
+		if( changed[ i ] == MeterBankPrivate::LeftBand && d->thresholdFired( i ) )
+			fired.append( qMakePair( i, d->thresholds.at( i ) ) );
+	}
+
+	if( !d->changedMeters.isEmpty() )
+		emit valuesChanged();
+
+	for( const auto & f : qAsConst( fired ) )
+		emit thresholdFired( f.first, f.second );
+}
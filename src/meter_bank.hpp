@@ -0,0 +1,106 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_BANK_HPP_INCLUDED
+#define METER_BANK_HPP_INCLUDED
+
+// Qt include.
+#include <QObject>
+#include <QScopedPointer>
+#include <QVector>
+
+// Widgets include.
+#include "meter_style.hpp"
+
+
+//
+// MeterBank
+//
+
+class MeterBankPrivate;
+
+/*!
+	\brief Values of many meters stored as contiguous arrays.
+
+	Whole frame of values is applied with setValues() in one pass:
+	range check, needle angles and threshold bands are computed for
+	all meters at once, and only meters that really changed are
+	reported with valuesChanged() and thresholdFired().
+*/
+class MeterBank Q_DECL_FINAL
+:  public QObject
+{
+	Q_OBJECT
+
+signals:
+	//! Values of meters in changedMeters() changed.
+	void valuesChanged();
+	//! Threshold of the meter.
+	void thresholdFired( int meterIndex, int thresholdIndex );
+
+public:
+	explicit MeterBank( QObject * parent = Q_NULLPTR );
+	virtual ~MeterBank();
+
+	//! Add meter. \return Index of the meter.
+	int addMeter( const MeterStyle & style );
+	//! \return Count of meters.
+	int count() const;
+
+	const MeterStyle & meterStyle( int meterIndex ) const;
+	void setMeterStyle( int meterIndex, const MeterStyle & s );
+
+	qreal value( int meterIndex ) const;
+	//! \return Angle of the needle.
+	qreal angle( int meterIndex ) const;
+	int currentThreshold( int meterIndex ) const;
+
+	//! \return Settings and value of the meter for MeterRenderer.
+	MeterSnapshot snapshot( int meterIndex ) const;
+
+	//! \return Indexes of meters changed by the last setValues() in ascending order.
+	const QVector< int > & changedMeters() const;
+
+	/*!
+		\brief Set values of meters.
+
+		\param values Values of meters starting with the first one,
+			values out of range of the meter are ignored.
+		\param count Count of values, extra values are ignored.
+	*/
+	void setValues( const qreal * values, size_t count );
+
+private:
+	Q_DISABLE_COPY( MeterBank )
+
+	QScopedPointer< MeterBankPrivate > d;
+}; // class MeterBank
+
+#endif // METER_BANK_HPP_INCLUDED
@@ -0,0 +1,124 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_clock_p.hpp"
+
+// Qt include.
+#include <QGuiApplication>
+#include <QScreen>
+#include <QtMath>
+
+// C++ include.
+#include <algorithm>
+
+
+//
+// MeterFrameClock
+//
+
+Q_GLOBAL_STATIC( MeterFrameClock, g_frameClock )
+
+MeterFrameClock::MeterFrameClock()
+	:  m_ticking( false )
+	,  m_lastTick( 0 )
+{
+	m_timer.setTimerType( Qt::PreciseTimer );
+
+	QObject::connect( &m_timer, &QTimer::timeout, [this] () { tick(); } );
+}
+
+MeterFrameClock *
+MeterFrameClock::instance()
+{
+	return g_frameClock();
+}
+
+void
+MeterFrameClock::add( Client * c )
+{
+	if( m_clients.contains( c ) )
+		return;
+
+	m_clients.append( c );
+
+	if( !m_timer.isActive() )
+	{
+		const QScreen * s = QGuiApplication::primaryScreen();
+		const qreal fps = ( s && s->refreshRate() > 0.0 ? s->refreshRate() : 60.0 );
+
+		m_elapsed.start();
+		m_lastTick = 0;
+		m_timer.start( qMax( 1, qRound( 1000.0 / fps ) ) );
+	}
+}
+
+void
+MeterFrameClock::remove( Client * c )
+{
+	const int i = m_clients.indexOf( c );
+
+	if( i < 0 )
+		return;
+
+	if( m_ticking )
+		m_clients[ i ] = Q_NULLPTR;
+	else
+	{
+		m_clients.remove( i );
+
+		if( m_clients.isEmpty() )
+			m_timer.stop();
+	}
+}
+
+void
+MeterFrameClock::tick()
+{
+	const qint64 now = m_elapsed.elapsed();
+	// Long stalls are not caught up, needles just continue moving.
+	const qreal dt = qMin( 0.1, ( now - m_lastTick ) / 1000.0 );
+
+	m_lastTick = now;
+	m_ticking = true;
+
+	for( int i = 0; i < m_clients.size(); ++i )
+	{
+		if( m_clients.at( i ) && !m_clients.at( i )->advance( dt ) )
+			m_clients[ i ] = Q_NULLPTR;
+	}
+
+	m_ticking = false;
+
+	m_clients.erase( std::remove( m_clients.begin(), m_clients.end(),
+		static_cast< Client* > ( Q_NULLPTR ) ), m_clients.end() );
+
+	if( m_clients.isEmpty() )
+		m_timer.stop();
+}
@@ -0,0 +1,92 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_CLOCK_P_HPP_INCLUDED
+#define METER_CLOCK_P_HPP_INCLUDED
+
+// Qt include.
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+
+
+//
+// MeterFrameClock
+//
+
+/*!
+	Frame clock shared by all animated meters in GUI thread. Ticks
+	only while there is any client, each client is removed as soon
+	as its animation settles.
+*/
+class MeterFrameClock Q_DECL_FINAL {
+public:
+	//! Animated object driven by the clock.
+	class Client {
+	public:
+		virtual ~Client()
+		{
+		}
+
+		//! Advance animation by dt seconds. \return Is it still moving.
+		virtual bool advance( qreal dt ) = 0;
+	}; // class Client
+
+	MeterFrameClock();
+
+	//! \return Shared clock or null if it's destroyed already.
+	static MeterFrameClock * instance();
+
+	//! Start driving the client, the clock starts if it's idle.
+	void add( Client * c );
+	//! Stop driving the client, the clock stops when there are no clients.
+	void remove( Client * c );
+
+	//! \return Is the clock ticking.
+	bool isActive() const
+	{
+		return m_timer.isActive();
+	}
+
+private:
+	Q_DISABLE_COPY( MeterFrameClock )
+
+	//! Advance all clients.
+	void tick();
+
+	//! Clients are advanced, removed ones are nulled till the end of the tick.
+	bool m_ticking;
+	qint64 m_lastTick;
+	QTimer m_timer;
+	QElapsedTimer m_elapsed;
+	QVector< Client* > m_clients;
+}; // class MeterFrameClock
+
+#endif // METER_CLOCK_P_HPP_INCLUDED
@@ -0,0 +1,79 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_history.hpp"
+
+
+//
+// MeterHistory
+//
+
+MeterHistory::MeterHistory( int capacity )
+	:  m_first( 0 )
+	,  m_size( 0 )
+{
+	setCapacity( capacity );
+}
+
+void
+MeterHistory::setCapacity( int c )
+{
+	m_samples.fill( { 0, 0.0 }, qMax( 0, c ) );
+	m_samples.squeeze();
+
+	clear();
+}
+
+void
+MeterHistory::append( qint64 time, qreal value )
+{
+	if( m_samples.isEmpty() )
+		return;
+
+	const MeterSample s = { time, value };
+
+	if( m_size < m_samples.size() )
+	{
+		m_samples[ ( m_first + m_size ) % m_samples.size() ] = s;
+		++m_size;
+	}
+	else
+	{
+		m_samples[ m_first ] = s;
+		m_first = ( m_first + 1 ) % m_samples.size();
+	}
+}
+
+void
+MeterHistory::clear()
+{
+	m_first = 0;
+	m_size = 0;
+}
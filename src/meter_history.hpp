@@ -0,0 +1,108 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_HISTORY_HPP_INCLUDED
+#define METER_HISTORY_HPP_INCLUDED
+
+// Qt include.
+#include <QVector>
+
+
+//
+// MeterSample
+//
+
+//! Timestamped value of the meter.
+struct MeterSample {
+	//! Time in milliseconds of the meter's monotonic clock.
+	qint64 time;
+	qreal value;
+}; // struct MeterSample
+
+Q_DECLARE_TYPEINFO( MeterSample, Q_PRIMITIVE_TYPE );
+
+
+//
+// MeterHistory
+//
+
+/*!
+	\brief Fixed capacity ring buffer of samples.
+
+	Memory is allocated when capacity is set, appending never
+	allocates and overwrites the oldest sample when the buffer is full.
+*/
+class MeterHistory Q_DECL_FINAL {
+public:
+	explicit MeterHistory( int capacity = 0 );
+
+	int capacity() const
+	{
+		return m_samples.size();
+	}
+
+	//! Set capacity, all samples are dropped.
+	void setCapacity( int c );
+
+	int size() const
+	{
+		return m_size;
+	}
+
+	bool isEmpty() const
+	{
+		return ( m_size == 0 );
+	}
+
+	//! \return Sample by index, 0 is the oldest one.
+	const MeterSample & at( int i ) const
+	{
+		return m_samples.at( ( m_first + i ) % m_samples.size() );
+	}
+
+	//! \return The newest sample.
+	const MeterSample & last() const
+	{
+		return at( m_size - 1 );
+	}
+
+	//! Append sample, the oldest one is overwritten if the buffer is full.
+	void append( qint64 time, qreal value );
+
+	void clear();
+
+private:
+	QVector< MeterSample > m_samples;
+	//! Index of the oldest sample.
+	int m_first;
+	int m_size;
+}; // class MeterHistory
+
+#endif // METER_HISTORY_HPP_INCLUDED
@@ -0,0 +1,304 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_panel_p.hpp"
+#include "meter_style_p.hpp"
+
+// Qt include.
+#include <QPainter>
+#include <QPaintEvent>
+
+
+//
+// MeterPanelPrivate
+//
+
+void
+MeterPanelPrivate::relayout()
+{
+	cell = QSize();
+
+	for( const auto & r : qAsConst( records ) )
+		cell = cell.expandedTo( MeterRenderer::size( r.style.settings() ) );
+
+	q->updateGeometry();
+	q->update();
+}
+
+void
+MeterPanelPrivate::paintMeter( QPainter & p, int index, qreal dpr )
+{
+	const Record & r = records.at( index );
+	const MeterSettings & s = r.style.settings();
+	const MeterStyleData * data = MeterStyleData::get( r.style );
+
+	p.save();
+	p.translate( q->meterRect( index ).topLeft() );
+	p.drawPixmap( 0, 0, data->face( dpr ) );
+	p.setRenderHint( QPainter::Antialiasing );
+	p.translate( 1.0, 1.0 );
+
+	MeterRendererPrivate::drawValueAndNeedle( p, s, data->drawParams(), r.value );
+
+	p.restore();
+}
+
+bool
+MeterPanelPrivate::thresholdFired( Record & r )
+{
+	const MeterThresholdIndex & bands = MeterStyleData::get( r.style )->bands();
+	const int band = bands.find( r.value );
+
+	if( band >= 0 && bands.at( band ).thresholdIndex != r.currentThreshold )
+	{
+		r.currentThreshold = bands.at( band ).thresholdIndex;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool
+MeterPanelPrivate::isValid( int index ) const
+{
+	return ( index >= 0 && index < records.size() );
+}
+
+
+//
+// MeterPanel
+//
+
+MeterPanel::MeterPanel( QWidget * parent )
+	:  QWidget( parent )
+	,  d( new MeterPanelPrivate( this ) )
+{
+}
+
+MeterPanel::~MeterPanel()
+{
+}
+
+int
+MeterPanel::columns() const
+{
+	return d->columns;
+}
+
+void
+MeterPanel::setColumns( int c )
+{
+	if( c > 0 )
+	{
+		d->columns = c;
+
+		d->relayout();
+	}
+}
+
+int
+MeterPanel::spacing() const
+{
+	return d->spacing;
+}
+
+void
+MeterPanel::setSpacing( int s )
+{
+	if( s >= 0 )
+	{
+		d->spacing = s;
+
+		d->relayout();
+	}
+}
+
+int
+MeterPanel::addMeter( const MeterSettings & settings )
+{
+	return addMeter( MeterStyle( settings ) );
+}
+
+int
+MeterPanel::addMeter( const MeterStyle & style )
+{
+	MeterPanelPrivate::Record r;
+	r.style = style;
+	r.value = style.settings().minValue;
+
+	d->records.append( r );
+
+	const int index = d->records.size() - 1;
+
+	if( d->thresholdFired( d->records[ index ] ) )
+		emit thresholdFired( index, d->records.at( index ).currentThreshold );
+
+	d->relayout();
+
+	return index;
+}
+
+int
+MeterPanel::count() const
+{
+	return d->records.size();
+}
+
+const MeterSettings &
+MeterPanel::settings( int meterIndex ) const
+{
+	return d->records.at( meterIndex ).style.settings();
+}
+
+void
+MeterPanel::setSettings( int meterIndex, const MeterSettings & s )
+{
+	setMeterStyle( meterIndex, MeterStyle( s ) );
+}
+
+const MeterStyle &
+MeterPanel::meterStyle( int meterIndex ) const
+{
+	return d->records.at( meterIndex ).style;
+}
+
+void
+MeterPanel::setMeterStyle( int meterIndex, const MeterStyle & s )
+{
+	if( d->isValid( meterIndex ) )
+	{
+		MeterPanelPrivate::Record & r = d->records[ meterIndex ];
+		r.style = s;
+
+		if( d->thresholdFired( r ) )
+			emit thresholdFired( meterIndex, r.currentThreshold );
+
+		d->relayout();
+	}
+}
+
+qreal
+MeterPanel::value( int meterIndex ) const
+{
+	return d->records.at( meterIndex ).value;
+}
+
+int
+MeterPanel::currentThreshold( int meterIndex ) const
+{
+	return d->records.at( meterIndex ).currentThreshold;
+}
+
+QRect
+MeterPanel::meterRect( int meterIndex ) const
+{
+	const int row = meterIndex / d->columns;
+	const int column = meterIndex % d->columns;
+
+	return QRect( column * ( d->cell.width() + d->spacing ),
+		row * ( d->cell.height() + d->spacing ),
+		d->cell.width(), d->cell.height() );
+}
+
+QSize
+MeterPanel::minimumSizeHint() const
+{
+	if( d->records.isEmpty() )
+		return QSize();
+
+	const int columns = qMin( d->records.size(), d->columns );
+	const int rows = ( d->records.size() + d->columns - 1 ) / d->columns;
+
+	return QSize( columns * ( d->cell.width() + d->spacing ) - d->spacing,
+		rows * ( d->cell.height() + d->spacing ) - d->spacing );
+}
+
+QSize
+MeterPanel::sizeHint() const
+{
+	return minimumSizeHint();
+}
+
+void
+MeterPanel::setValue( int meterIndex, qreal v )
+{
+	if( !d->isValid( meterIndex ) )
+		return;
+
+	MeterPanelPrivate::Record & r = d->records[ meterIndex ];
+	const MeterSettings & s = r.style.settings();
+
+	if( ( v > s.minValue || qAbs( v - s.minValue ) < 0.000001 ) &&
+		( v < s.maxValue || qAbs( v - s.maxValue ) < 0.000001 ) )
+	{
+		r.value = v;
+
+		update( meterRect( meterIndex ) );
+
+		emit valueChanged( meterIndex, v );
+
+		if( d->thresholdFired( r ) )
+			emit thresholdFired( meterIndex, r.currentThreshold );
+	}
+}
+
+void
+MeterPanel::paintEvent( QPaintEvent * e )
+{
+	if( d->records.isEmpty() || d->cell.isEmpty() )
+		return;
+
+	QPainter p( this );
+
+	const qreal dpr = devicePixelRatioF();
+	const QRect r = e->rect();
+	const int w = d->cell.width() + d->spacing;
+	const int h = d->cell.height() + d->spacing;
+	const int firstColumn = qMax( 0, r.left() / w );
+	const int lastColumn = qMin( d->columns - 1, r.right() / w );
+	const int firstRow = qMax( 0, r.top() / h );
+	const int lastRow = r.bottom() / h;
+
+	// Only meters intersecting the dirty region are painted.
+	for( int row = firstRow; row <= lastRow; ++row )
+	{
+		for( int column = firstColumn; column <= lastColumn; ++column )
+		{
+			const int i = row * d->columns + column;
+
+			if( i >= d->records.size() )
+				return;
+
+			if( e->region().intersects( meterRect( i ) ) )
+				d->paintMeter( p, i, dpr );
+		}
+	}
+}
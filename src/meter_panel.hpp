@@ -0,0 +1,114 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_PANEL_HPP_INCLUDED
+#define METER_PANEL_HPP_INCLUDED
+
+// Qt include.
+#include <QWidget>
+#include <QScopedPointer>
+
+// Widgets include.
+#include "meter_renderer.hpp"
+#include "meter_style.hpp"
+
+
+//
+// MeterPanel
+//
+
+class MeterPanelPrivate;
+
+/*!
+	\brief Widget that hosts many lightweight meters in a grid.
+
+	Meters are plain records addressed by index, not widgets. Changed
+	meters are repainted in one paintEvent() of the panel. Meters added
+	with the same MeterStyle share its rendered face.
+*/
+class MeterPanel Q_DECL_FINAL
+:  public QWidget
+{
+	Q_OBJECT
+
+	Q_PROPERTY( int columns READ columns WRITE setColumns )
+	Q_PROPERTY( int spacing READ spacing WRITE setSpacing )
+
+signals:
+	//! Value of the meter changed.
+	void valueChanged( int meterIndex, qreal currentValue );
+	//! Threshold of the meter.
+	void thresholdFired( int meterIndex, int thresholdIndex );
+
+public:
+	MeterPanel( QWidget * parent = Q_NULLPTR );
+	virtual ~MeterPanel();
+
+	int columns() const;
+	void setColumns( int c );
+
+	int spacing() const;
+	void setSpacing( int s );
+
+	//! Add meter. \return Index of the meter.
+	int addMeter( const MeterSettings & settings );
+	//! Add meter. \return Index of the meter.
+	int addMeter( const MeterStyle & style );
+	//! \return Count of meters.
+	int count() const;
+
+	const MeterSettings & settings( int meterIndex ) const;
+	void setSettings( int meterIndex, const MeterSettings & s );
+
+	const MeterStyle & meterStyle( int meterIndex ) const;
+	void setMeterStyle( int meterIndex, const MeterStyle & s );
+
+	qreal value( int meterIndex ) const;
+	int currentThreshold( int meterIndex ) const;
+
+	//! \return Rectangle of the meter in the panel.
+	QRect meterRect( int meterIndex ) const;
+
+	QSize minimumSizeHint() const Q_DECL_OVERRIDE;
+	QSize sizeHint() const Q_DECL_OVERRIDE;
+
+public slots:
+	void setValue( int meterIndex, qreal v );
+
+protected:
+	void paintEvent( QPaintEvent * e ) Q_DECL_OVERRIDE;
+
+private:
+	Q_DISABLE_COPY( MeterPanel )
+
+	QScopedPointer< MeterPanelPrivate > d;
+}; // class MeterPanel
+
+#endif // METER_PANEL_HPP_INCLUDED
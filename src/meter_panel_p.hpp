@@ -0,0 +1,90 @@
+
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_PANEL_P_HPP_INCLUDED
+#define METER_PANEL_P_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_panel.hpp"
+
+// Qt include.
+#include <QVector>
+#include <QSize>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+
+//
+// MeterPanelPrivate
+//
+
+class MeterPanelPrivate {
+public:
+	explicit MeterPanelPrivate( MeterPanel * parent )
+		:  columns( 10 )
+		,  spacing( 2 )
+		,  q( parent )
+	{
+	}
+
+	//! Lightweight meter, face and threshold bands are in the style.
+	struct Record {
+		Record()
+			:  value( 0.0 )
+			,  currentThreshold( 0 )
+		{
+		}
+
+		MeterStyle style;
+		qreal value;
+		int currentThreshold;
+	};
+
+	//! Recalculate size of the cell.
+	void relayout();
+	//! Paint meter at its place in the grid.
+	void paintMeter( QPainter & p, int index, qreal dpr );
+	//! \return Is threshold of the meter changed.
+	bool thresholdFired( Record & r );
+	//! \return Is index of the meter valid.
+	bool isValid( int index ) const;
+
+	int columns;
+	int spacing;
+	//! Size of the grid's cell, fits the biggest meter.
+	QSize cell;
+	QVector< Record > records;
+	MeterPanel * q;
+}; // class MeterPanelPrivate
+
+#endif // METER_PANEL_P_HPP_INCLUDED
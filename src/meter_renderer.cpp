@@ -0,0 +1,799 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_renderer_p.hpp"
+
+// Qt include.
+#include <QPainter>
+#include <QtMath>
+#include <QRadialGradient>
+#include <QFontMetricsF>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QElapsedTimer>
+
+// C++ include.
+#include <algorithm>
+#include <cmath>
+
+
+//
+// MeterSettings
+//
+
+MeterSettings::MeterSettings()
+	:  drawValue( true )
+	,  drawGridValues( true )
+	,  valuePrecision( 0 )
+	,  scalePrecision( 0 )
+	,  radius( 100 )
+	,  startScaleAngle( 30 )
+	,  stopScaleAngle( 330 )
+	,  minValue( 0.0 )
+	,  maxValue( 100.0 )
+	,  scaleStep( 1.0 )
+	,  scaleGridStep( 10.0 )
+	,  backgroundColor( Qt::black )
+	,  needleColor( Qt::blue )
+	,  textColor( Qt::white )
+	,  gridColor( Qt::white )
+	,  markerColor( Qt::red )
+	,  statsBandColor( 255, 255, 0, 96 )
+{
+}
+
+
+//
+// MeterRenderStats
+//
+
+MeterRenderStats::MeterRenderStats()
+	:  paints( 0 )
+	,  samplesReceived( 0 )
+	,  samplesCoalesced( 0 )
+	,  skippedUpdates( 0 )
+	,  thresholdSignals( 0 )
+	,  faceRebuilds( 0 )
+{
+	std::fill( layerTime, layerTime + LayersCount, 0 );
+	std::fill( paintTimeHistogram, paintTimeHistogram + c_histogramSize, 0 );
+}
+
+void
+MeterRenderStats::addPaintTime( qint64 ns )
+{
+	const qreal us = ns / 1000.0;
+	const int i = ( us < 1.0 ? 0 : static_cast< int > ( std::log2( us ) * 4.0 ) );
+
+	++paintTimeHistogram[ qBound( 0, i, c_histogramSize - 1 ) ];
+}
+
+qreal
+MeterRenderStats::paintTimePercentile( qreal p ) const
+{
+	quint64 total = 0;
+
+	for( int i = 0; i < c_histogramSize; ++i )
+		total += paintTimeHistogram[ i ];
+
+	if( total == 0 )
+		return 0.0;
+
+	const quint64 rank = qMax( quint64( 1 ),
+		quint64( qCeil( total * qBound( 0.0, p, 1.0 ) ) ) );
+	quint64 count = 0;
+
+	for( int i = 0; i < c_histogramSize; ++i )
+	{
+		count += paintTimeHistogram[ i ];
+
+		// Geometric middle of the bucket.
+		if( count >= rank )
+			return bucketStart( i ) * std::pow( 2.0, 0.125 );
+	}
+
+	return bucketStart( c_histogramSize );
+}
+
+qreal
+MeterRenderStats::bucketStart( int i )
+{
+	return std::pow( 2.0, i / 4.0 );
+}
+
+
+//
+// MeterSnapshot
+//
+
+MeterSnapshot::MeterSnapshot()
+	:  value( 0.0 )
+{
+}
+
+MeterSnapshot::MeterSnapshot( const MeterSettings & s, qreal v )
+	:  settings( s )
+	,  value( v )
+{
+}
+
+
+//
+// MeterRendererPrivate
+//
+
+namespace /* anonymous */ {
+
+//! Minimum distance in pixels between ticks on the scale.
+static const qreal c_minTickSpacing = 3.0;
+
+//! \return Count of steps, limited to keep it in int.
+inline int
+stepsCount( qreal range, qreal step )
+{
+	return static_cast< int > ( qMin( range / step, 1000000000.0 ) );
+}
+
+//! \return Stride between drawn ticks so they fit into the arc.
+inline int
+tickStride( int stepsCount, qreal arcLength )
+{
+	const int maxTicks = qMax( 1, static_cast< int > ( arcLength / c_minTickSpacing ) );
+
+	return ( stepsCount > maxTicks ? ( stepsCount + maxTicks - 1 ) / maxTicks : 1 );
+}
+
+//! \return Static text prepared for drawing with the font.
+inline QStaticText
+staticText( const QString & text, const QFont & font )
+{
+	QStaticText st( text );
+	st.setTextFormat( Qt::PlainText );
+	st.setPerformanceHint( QStaticText::AggressiveCaching );
+	st.prepare( QTransform(), font );
+
+	return st;
+}
+
+//! Extend rectangle to contain the point.
+inline void
+extendRect( QRectF & r, const QPointF & p )
+{
+	r.setLeft( qMin( r.left(), p.x() ) );
+	r.setRight( qMax( r.right(), p.x() ) );
+	r.setTop( qMin( r.top(), p.y() ) );
+	r.setBottom( qMax( r.bottom(), p.y() ) );
+}
+
+} /* namespace anonymous */
+
+MeterRendererPrivate::DrawParams
+MeterRendererPrivate::drawParams( const MeterSettings & s )
+{
+	DrawParams params;
+
+	params.rect = QRectF( 0.0, 0.0, s.radius * 2, s.radius * 2 );
+	params.scaleDegree = s.stopScaleAngle - s.startScaleAngle;
+	params.startScaleAngle = s.startScaleAngle;
+	params.margin = s.radius / 20.0;
+
+	const qreal gridLabelSizeFactor = 10.0;
+
+	params.scaleWidth = s.radius / ( gridLabelSizeFactor + 20.0 );
+	params.gridLabelSize = s.radius / gridLabelSizeFactor;
+	params.fontPixelSize = params.gridLabelSize * 0.75;
+	params.scale = MeterScaleTable( s.scale, s.minValue, s.maxValue );
+
+	return params;
+}
+
+qreal
+MeterRendererPrivate::needleAngle( const MeterSettings & s, const DrawParams & params,
+	qreal v )
+{
+	Q_UNUSED( s )
+
+	return params.startScaleAngle + params.scaleDegree * params.scale.fraction( v );
+}
+
+QRectF
+MeterRendererPrivate::valueLabelRect( const MeterSettings & s, const DrawParams & params )
+{
+	return QRectF( 0, s.radius * 2 - params.margin - params.gridLabelSize * 2,
+		s.radius * 2, s.radius );
+}
+
+QString
+MeterRendererPrivate::valueText( const MeterSettings & s, qreal v )
+{
+	return QString::number( v, 'f', s.valuePrecision );
+}
+
+QFont
+MeterRendererPrivate::valueFont( const MeterSettings & s, const DrawParams & params )
+{
+	QFont f = s.font;
+	f.setPixelSize( params.fontPixelSize * 2 );
+	f.setBold( true );
+
+	return f;
+}
+
+QLineF
+MeterRendererPrivate::tickLine( qreal angle, qreal from, qreal to )
+{
+	// QPainter::rotate() maps ( 0, y ) to ( -y * sin, y * cos ).
+	const qreal a = qDegreesToRadians( angle );
+	const qreal sina = qSin( a );
+	const qreal cosa = qCos( a );
+
+	return QLineF( -from * sina, from * cosa, -to * sina, to * cosa );
+}
+
+MeterRendererPrivate::TickGeometry
+MeterRendererPrivate::ticks( const MeterSettings & s, const DrawParams & params )
+{
+	const qreal outer = s.radius - params.margin;
+	const qreal arcLength = qDegreesToRadians( params.scaleDegree ) * outer;
+
+	TickGeometry ticks;
+
+	if( params.scale.type() == MeterScale::Logarithmic )
+	{
+		// Grid at powers of 10, minor ticks at their multiples.
+		const qreal minSpacing = qRadiansToDegrees( c_minTickSpacing / outer );
+		const int first = qFloor( std::log10( s.minValue ) );
+		const int last = qCeil( std::log10( s.maxValue ) );
+		qreal lastAngle = -360.0;
+
+		for( int e = first; e <= last; ++e )
+		{
+			const qreal decade = std::pow( 10.0, e );
+
+			for( int m = 1; m < 10; ++m )
+			{
+				const qreal v = decade * m;
+
+				if( v < s.minValue * ( 1.0 - 0.000001 ) || v > s.maxValue * ( 1.0 + 0.000001 ) )
+					continue;
+
+				const qreal angle = needleAngle( s, params, v );
+
+				if( qAbs( angle - lastAngle ) < minSpacing )
+					continue;
+
+				lastAngle = angle;
+
+				if( m == 1 )
+				{
+					ticks.gridValues.append( v );
+					ticks.major.append( tickLine( angle, outer, outer - params.gridLabelSize ) );
+				}
+				else
+					ticks.minor.append( tickLine( angle, outer, outer - params.scaleWidth ) );
+			}
+		}
+
+		return ticks;
+	}
+
+	int gridStepsCount = 0;
+	int gridStride = 1;
+
+	if( s.scaleGridStep > 0.0 )
+		gridStepsCount = stepsCount( s.maxValue - s.minValue, s.scaleGridStep );
+
+	if( gridStepsCount > 0 )
+	{
+		gridStride = tickStride( gridStepsCount, arcLength );
+
+		ticks.gridValues.reserve( gridStepsCount / gridStride + 1 );
+		ticks.major.reserve( gridStepsCount / gridStride + 1 );
+
+		for( int i = 0; i <= gridStepsCount; i += gridStride )
+		{
+			const qreal v = s.minValue + i * s.scaleGridStep;
+
+			ticks.gridValues.append( v );
+			ticks.major.append( tickLine( needleAngle( s, params, v ),
+				outer, outer - params.gridLabelSize ) );
+		}
+	}
+	else
+	{
+		ticks.major.append( tickLine( params.startScaleAngle,
+			outer, outer - params.gridLabelSize ) );
+		ticks.major.append( tickLine( params.startScaleAngle + params.scaleDegree,
+			outer, outer - params.gridLabelSize ) );
+	}
+
+	const int count = ( s.scaleStep > 0.0 ?
+		stepsCount( s.maxValue - s.minValue, s.scaleStep ) : 0 );
+
+	if( count > 1 )
+	{
+		const int stride = tickStride( count, arcLength );
+
+		ticks.minor.reserve( count / stride );
+
+		for( int i = stride; i < count; i += stride )
+		{
+			const qreal offset = i * s.scaleStep;
+
+			// Skip ticks that coincide with the drawn grid ticks.
+			if( gridStepsCount > 0 )
+			{
+				const int gridIndex = qRound( offset / s.scaleGridStep );
+
+				if( gridIndex % gridStride == 0 &&
+					qAbs( gridIndex * s.scaleGridStep - offset ) < 0.000001 )
+						continue;
+			}
+
+			ticks.minor.append( tickLine( needleAngle( s, params, s.minValue + offset ),
+				outer, outer - params.scaleWidth ) );
+		}
+	}
+
+	return ticks;
+}
+
+MeterRendererPrivate::LabelCache
+MeterRendererPrivate::labels( const MeterSettings & s, const DrawParams & params,
+	const TickGeometry & ticks )
+{
+	LabelCache labels;
+	labels.font = s.font;
+	labels.font.setPixelSize( params.fontPixelSize );
+
+	const QFontMetricsF fm( labels.font );
+
+	if( !ticks.gridValues.isEmpty() && s.drawGridValues )
+	{
+		const qreal offset = ( s.radius - params.gridLabelSize - params.margin * 3 );
+		const bool logarithmic = ( params.scale.type() == MeterScale::Logarithmic );
+
+		labels.grid.reserve( ticks.gridValues.size() );
+		labels.gridPositions.reserve( ticks.gridValues.size() );
+
+		for( const qreal v : ticks.gridValues )
+		{
+			const QPointF p = tickLine( needleAngle( s, params, v ), offset, offset ).p1();
+
+			const QString str = ( logarithmic ? QString::number( v, 'g' ) :
+				QString::number( v, 'f', s.scalePrecision ) );
+
+			const QSizeF size = fm.size( Qt::TextSingleLine, str );
+
+			const int x = p.x() - ( size.width() / 2 );
+			const int y = p.y() + ( size.height() / 4 );
+
+			// Static text is positioned by top left corner, not by base line.
+			labels.grid.append( staticText( str, labels.font ) );
+			labels.gridPositions.append( QPointF( x + s.radius, y + s.radius - fm.ascent() ) );
+		}
+	}
+
+	if( !s.unitsLabel.isEmpty() )
+	{
+		labels.units = staticText( s.unitsLabel, labels.font );
+		labels.unitsPosition = QPointF( s.radius - labels.units.size().width() / 2.0,
+			params.margin * 3 + params.gridLabelSize * 3 );
+	}
+
+	if( !s.label.isEmpty() )
+	{
+		labels.title = staticText( s.label, labels.font );
+		labels.titlePosition = QPointF( s.radius - labels.title.size().width() / 2.0,
+			s.radius * 2 - params.margin * 3 - params.gridLabelSize * 3 );
+	}
+
+	return labels;
+}
+
+void
+MeterRendererPrivate::drawBackground( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params )
+{
+	painter.save();
+	painter.setPen( s.backgroundColor );
+	painter.setBrush( s.backgroundColor );
+	painter.drawEllipse( params.rect );
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawRanges( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params )
+{
+	const qreal m = params.margin + params.scaleWidth / 2.0;
+
+	const QRectF r = params.rect - QMarginsF( m, m, m,m );
+
+	painter.save();
+
+	for( auto it = s.ranges.cbegin(), last = s.ranges.cend(); it != last; ++it )
+	{
+		painter.setPen( QPen( it.value().color, params.scaleWidth ) );
+		const qreal angle = needleAngle( s, params, it.value().start );
+		const qreal span = needleAngle( s, params, it.value().stop ) - angle;
+		painter.drawArc( r, ( -90.0 - angle ) * 16, -span * 16 );
+	}
+
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawScale( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, const TickGeometry & ticks )
+{
+	painter.save();
+	painter.setPen( s.textColor );
+	painter.drawArc( params.rect -
+	QMarginsF( params.margin, params.margin, params.margin, params.margin ),
+		( -90.0 - params.startScaleAngle ) * 16, -params.scaleDegree * 16 );
+	painter.translate( s.radius, s.radius );
+	painter.drawLines( ticks.major );
+	painter.drawLines( ticks.minor );
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawLabels( QPainter & painter, const MeterSettings & s,
+	const LabelCache & labels )
+{
+	painter.save();
+	painter.setFont( labels.font );
+	painter.setPen( s.textColor );
+
+	for( int i = 0, last = labels.grid.size(); i < last; ++i )
+		painter.drawStaticText( labels.gridPositions.at( i ), labels.grid.at( i ) );
+
+	if( !labels.units.text().isEmpty() )
+		painter.drawStaticText( labels.unitsPosition, labels.units );
+
+	if( !labels.title.text().isEmpty() )
+		painter.drawStaticText( labels.titlePosition, labels.title );
+
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawValueLabel( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal v )
+{
+	painter.save();
+	painter.setFont( valueFont( s, params ) );
+	painter.setPen( s.textColor );
+	painter.drawText( valueLabelRect( s, params ), valueText( s, v ),
+		QTextOption( Qt::AlignHCenter ) );
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawNeedle( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal angle )
+{
+	drawNeedle( painter, s, params, angle, s.needleColor );
+}
+
+void
+MeterRendererPrivate::drawNeedle( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal angle, const QColor & color )
+{
+	const qreal r = s.radius / 10.0;
+
+	painter.save();
+	painter.translate( s.radius, s.radius );
+	painter.rotate( angle );
+	painter.setPen( QPen( color, s.radius / 75.0 ) );
+	painter.drawLine( 0, s.radius - params.margin, 0, - ( r * 2.0 ) );
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawHub( QPainter & painter, const MeterSettings & s )
+{
+	const qreal r = s.radius / 10.0;
+
+	painter.save();
+	painter.setBrush( s.backgroundColor );
+	painter.setPen( Qt::NoPen );
+	painter.drawEllipse( -r, -r, r * 2.0, r * 2.0 );
+
+	const auto c = s.backgroundColor.redF() + s.backgroundColor.greenF() +
+		s.backgroundColor.blueF();
+	QRadialGradient gradient( 0.0, 0.0, r, r, r );
+
+	if( c < 1.0 )
+	{
+		gradient.setColorAt( 0.0, s.textColor );
+		gradient.setColorAt( 1.0, Qt::transparent );
+	}
+	else
+	{
+		gradient.setColorAt( 1.0, s.textColor );
+		gradient.setColorAt( 0.0, Qt::transparent );
+	}
+
+	painter.setBrush( gradient );
+	painter.drawEllipse( -r, -r, r * 2.0, r * 2.0 );
+	painter.restore();
+}
+
+QRectF
+MeterRendererPrivate::trailRect( const MeterSettings & s )
+{
+	return QRectF( s.radius * 0.6, s.radius * 1.15, s.radius * 0.8, s.radius * 0.25 );
+}
+
+QLineF
+MeterRendererPrivate::markerLine( const MeterSettings & s, const DrawParams & params,
+	qreal angle )
+{
+	const qreal outer = s.radius - params.margin;
+
+	return tickLine( angle, outer, outer - params.gridLabelSize * 0.5 );
+}
+
+qreal
+MeterRendererPrivate::markerWidth( const DrawParams & params )
+{
+	return params.scaleWidth * 2.0;
+}
+
+void
+MeterRendererPrivate::drawMarker( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal angle )
+{
+	painter.save();
+	painter.setPen( QPen( s.markerColor, markerWidth( params ), Qt::SolidLine, Qt::FlatCap ) );
+	painter.drawLine( markerLine( s, params, angle ) );
+	painter.restore();
+}
+
+qreal
+MeterRendererPrivate::statsBandOuter( const MeterSettings & s, const DrawParams & params )
+{
+	return s.radius - params.margin - params.scaleWidth;
+}
+
+qreal
+MeterRendererPrivate::statsBandInner( const MeterSettings & s, const DrawParams & params )
+{
+	return statsBandOuter( s, params ) - params.scaleWidth;
+}
+
+QRectF
+MeterRendererPrivate::sectorRect( qreal from, qreal to, qreal inner, qreal outer )
+{
+	if( from > to )
+		qSwap( from, to );
+
+	const QLineF a = tickLine( from, inner, outer );
+	const QLineF b = tickLine( to, inner, outer );
+
+	QRectF r = QRectF( a.p1(), a.p2() ).normalized();
+	extendRect( r, b.p1() );
+	extendRect( r, b.p2() );
+
+	// Extreme points of the outer arc along axes.
+	for( qreal angle = qCeil( from / 90.0 ) * 90.0; angle < to; angle += 90.0 )
+		extendRect( r, tickLine( angle, outer, outer ).p1() );
+
+	return r;
+}
+
+void
+MeterRendererPrivate::drawStatsBand( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal from, qreal to, qreal p95, qreal p99 )
+{
+	const qreal outer = statsBandOuter( s, params );
+	const qreal inner = statsBandInner( s, params );
+	const qreal r = ( outer + inner ) / 2.0;
+	const qreal bandWidth = params.scaleWidth;
+
+	painter.save();
+	painter.setPen( QPen( s.statsBandColor, bandWidth, Qt::SolidLine, Qt::FlatCap ) );
+	painter.drawArc( QRectF( -r, -r, r * 2.0, r * 2.0 ),
+		qRound( ( -90.0 - from ) * 16 ), qRound( -( to - from ) * 16 ) );
+
+	QColor tickColor = s.statsBandColor;
+	tickColor.setAlpha( 255 );
+
+	painter.setPen( QPen( tickColor, qMax( 1.0, params.scaleWidth / 2.0 ),
+		Qt::SolidLine, Qt::FlatCap ) );
+	painter.drawLine( tickLine( p95, inner, outer ) );
+	painter.drawLine( tickLine( p99, inner, outer ) );
+	painter.restore();
+}
+
+void
+MeterRendererPrivate::drawFace( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, const TickGeometry & ticks, const LabelCache & labels,
+	MeterRenderStats * stats )
+{
+	if( !stats )
+	{
+		drawBackground( painter, s, params );
+		drawRanges( painter, s, params );
+		drawScale( painter, s, params, ticks );
+		drawLabels( painter, s, labels );
+
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	drawBackground( painter, s, params );
+	stats->layerTime[ MeterRenderStats::Background ] += timer.nsecsElapsed();
+	timer.start();
+
+	drawRanges( painter, s, params );
+	stats->layerTime[ MeterRenderStats::Ranges ] += timer.nsecsElapsed();
+	timer.start();
+
+	drawScale( painter, s, params, ticks );
+	stats->layerTime[ MeterRenderStats::Scale ] += timer.nsecsElapsed();
+	timer.start();
+
+	drawLabels( painter, s, labels );
+	stats->layerTime[ MeterRenderStats::Labels ] += timer.nsecsElapsed();
+}
+
+void
+MeterRendererPrivate::drawValueAndNeedle( QPainter & painter, const MeterSettings & s,
+	const DrawParams & params, qreal v )
+{
+	if( s.drawValue )
+		drawValueLabel( painter, s, params, v );
+
+	drawNeedle( painter, s, params, needleAngle( s, params, v ) );
+
+	painter.save();
+	painter.translate( s.radius, s.radius );
+	drawHub( painter, s );
+	painter.restore();
+}
+
+
+//
+// RenderTask
+//
+
+namespace /* anonymous */ {
+
+//! Renders one snapshot on the thread pool.
+class RenderTask Q_DECL_FINAL
+	:  public QRunnable
+{
+public:
+	RenderTask( const MeterSnapshot & snapshot, qreal dpr, QImage * image,
+		QSemaphore * done )
+		:  m_snapshot( snapshot )
+		,  m_dpr( dpr )
+		,  m_image( image )
+		,  m_done( done )
+	{
+		setAutoDelete( true );
+	}
+
+	void run() Q_DECL_OVERRIDE
+	{
+		*m_image = MeterRenderer::render( m_snapshot, m_dpr );
+
+		m_done->release();
+	}
+
+private:
+	const MeterSnapshot & m_snapshot;
+	qreal m_dpr;
+	QImage * m_image;
+	QSemaphore * m_done;
+}; // class RenderTask
+
+} /* namespace anonymous */
+
+
+//
+// MeterRenderer
+//
+
+QSize
+MeterRenderer::size( const MeterSettings & settings )
+{
+	return QSize( settings.radius * 2 + 2, settings.radius * 2 + 2 );
+}
+
+void
+MeterRenderer::paint( QPainter & painter, const MeterSnapshot & snapshot )
+{
+	const MeterSettings & s = snapshot.settings;
+	const auto params = MeterRendererPrivate::drawParams( s );
+	const auto ticks = MeterRendererPrivate::ticks( s, params );
+
+	painter.save();
+	painter.setRenderHint( QPainter::Antialiasing );
+	painter.translate( 1.0, 1.0 );
+
+	MeterRendererPrivate::drawFace( painter, s, params, ticks,
+		MeterRendererPrivate::labels( s, params, ticks ) );
+	MeterRendererPrivate::drawValueAndNeedle( painter, s, params, snapshot.value );
+
+	painter.restore();
+}
+
+void
+MeterRenderer::paint( QPaintDevice * device, const MeterSnapshot & snapshot )
+{
+	QPainter p( device );
+
+	paint( p, snapshot );
+}
+
+QImage
+MeterRenderer::render( const MeterSnapshot & snapshot, qreal dpr )
+{
+	const QSize s = size( snapshot.settings );
+
+	QImage image( qCeil( s.width() * dpr ), qCeil( s.height() * dpr ),
+		QImage::Format_ARGB32_Premultiplied );
+	image.setDevicePixelRatio( dpr );
+	image.fill( Qt::transparent );
+
+	paint( &image, snapshot );
+
+	return image;
+}
+
+QVector< QImage >
+MeterRenderer::render( const QVector< MeterSnapshot > & snapshots, qreal dpr,
+	QThreadPool * pool )
+{
+	QVector< QImage > images( snapshots.size() );
+
+	if( snapshots.isEmpty() )
+		return images;
+
+	if( !pool )
+		pool = QThreadPool::globalInstance();
+
+	QSemaphore done;
+	QImage * data = images.data();
+
+	for( int i = 0; i < snapshots.size(); ++i )
+		pool->start( new RenderTask( snapshots.at( i ), dpr, data + i, &done ) );
+
+	done.acquire( snapshots.size() );
+
+	return images;
+}
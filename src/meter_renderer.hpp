@@ -0,0 +1,205 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_RENDERER_HPP_INCLUDED
+#define METER_RENDERER_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_scale.hpp"
+
+// Qt include.
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QMultiMap>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+class QPaintDevice;
+class QThreadPool;
+QT_END_NAMESPACE
+
+
+//
+// MeterRange
+//
+
+//! Threshold range [start, stop) of the meter.
+struct MeterRange {
+	qreal start;
+	qreal stop;
+	QColor color;
+}; // struct MeterRange
+
+
+//
+// MeterSettings
+//
+
+//! Everything that defines look of the meter.
+struct MeterSettings {
+	MeterSettings();
+
+	bool drawValue;
+	bool drawGridValues;
+	int valuePrecision;
+	int scalePrecision;
+	uint radius;
+	uint startScaleAngle;
+	uint stopScaleAngle;
+	qreal minValue;
+	qreal maxValue;
+	qreal scaleStep;
+	qreal scaleGridStep;
+	QColor backgroundColor;
+	QColor needleColor;
+	QColor textColor;
+	QColor gridColor;
+	//! Color of peak and trough markers.
+	QColor markerColor;
+	//! Color of the band of value statistics.
+	QColor statsBandColor;
+	QString label;
+	QString unitsLabel;
+	//! Font, pixel size is defined by radius.
+	QFont font;
+	//! Threshold ranges by threshold index.
+	QMultiMap< int, MeterRange > ranges;
+	//! Mapping of values to the arc of the scale.
+	MeterScale scale;
+}; // struct MeterSettings
+
+
+//
+// MeterSnapshot
+//
+
+//! Settings and value of the meter.
+struct MeterSnapshot {
+	MeterSnapshot();
+	MeterSnapshot( const MeterSettings & s, qreal v );
+
+	MeterSettings settings;
+	qreal value;
+}; // struct MeterSnapshot
+
+
+//
+// MeterRenderStats
+//
+
+//! Render cost of the meter, collected when instrumentation is on.
+struct MeterRenderStats {
+	MeterRenderStats();
+
+	//! Layers of the meter.
+	enum Layer {
+		//! Layers of the face are timed only when the face is rebuilt.
+		Background = 0,
+		Ranges,
+		Scale,
+		Labels,
+		//! Blit of the cached face including its rebuild.
+		Face,
+		//! Value statistics band, peak and trough markers and history trail.
+		Overlays,
+		ValueLabel,
+		Needle,
+		LayersCount
+	}; // enum Layer
+
+	//! Count of buckets in the paint time histogram.
+	static const int c_histogramSize = 64;
+
+	//! Add paint time in nanoseconds to the histogram.
+	void addPaintTime( qint64 ns );
+	//! \return Percentile of paint time in microseconds, p is in [0, 1].
+	qreal paintTimePercentile( qreal p ) const;
+	//! \return Start of the histogram's bucket in microseconds.
+	static qreal bucketStart( int i );
+
+	quint64 paints;
+	quint64 samplesReceived;
+	//! Samples replaced by newer ones before being painted.
+	quint64 samplesCoalesced;
+	//! Values dropped by the perceptual filter.
+	quint64 skippedUpdates;
+	quint64 thresholdSignals;
+	quint64 faceRebuilds;
+	//! Total time of each layer in nanoseconds.
+	qint64 layerTime[ LayersCount ];
+	//! Bucket i counts paints of [2^(i/4), 2^((i+1)/4)) microseconds.
+	quint64 paintTimeHistogram[ c_histogramSize ];
+}; // struct MeterRenderStats
+
+
+//
+// MeterRenderer
+//
+
+/*!
+	\brief Renderer of the meter without widget.
+
+	Reentrant, doesn't use any shared state, so may be used from any
+	thread at once, e.g. with offscreen platform.
+*/
+class MeterRenderer Q_DECL_FINAL {
+public:
+	//! \return Size of the meter's image in device independent pixels.
+	static QSize size( const MeterSettings & settings );
+
+	//! Paint meter with the top left corner at the painter's origin.
+	static void paint( QPainter & painter, const MeterSnapshot & snapshot );
+	//! Paint meter on the device.
+	static void paint( QPaintDevice * device, const MeterSnapshot & snapshot );
+
+	//! \return Image of the meter.
+	static QImage render( const MeterSnapshot & snapshot, qreal dpr = 1.0 );
+
+	/*!
+		\brief Render meters in parallel.
+
+		\param snapshots Meters to render.
+		\param dpr Device pixel ratio of images.
+		\param pool Pool to run on, global one if null.
+
+		\return Images in order of snapshots.
+	*/
+	static QVector< QImage > render( const QVector< MeterSnapshot > & snapshots,
+		qreal dpr = 1.0, QThreadPool * pool = Q_NULLPTR );
+
+private:
+	MeterRenderer();
+}; // class MeterRenderer
+
+#endif // METER_RENDERER_HPP_INCLUDED
@@ -0,0 +1,164 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_RENDERER_P_HPP_INCLUDED
+#define METER_RENDERER_P_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_renderer.hpp"
+#include "meter_scale_p.hpp"
+
+// Qt include.
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+#include <QStaticText>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+
+//
+// MeterRendererPrivate
+//
+
+//! Steps of drawing the meter shared by MeterRenderer and Meter.
+class MeterRendererPrivate {
+public:
+	struct DrawParams {
+		QRectF rect;
+		qreal scaleDegree;
+		qreal startScaleAngle;
+		qreal margin;
+		qreal gridLabelSize;
+		qreal scaleWidth;
+		qreal fontPixelSize;
+		//! Mapping of values to fractions of the arc.
+		MeterScaleTable scale;
+	};
+
+	//! Precomputed ticks of the scale, relative to the center.
+	struct TickGeometry {
+		QVector< QLineF > major;
+		QVector< QLineF > minor;
+		//! Values of drawn grid ticks, labels are drawn for them.
+		QVector< qreal > gridValues;
+	};
+
+	//! Laid out static labels, positions are relative to the face.
+	struct LabelCache {
+		LabelCache()
+			:  dpr( 0.0 )
+		{
+		}
+
+		QFont font;
+		qreal dpr;
+		QVector< QStaticText > grid;
+		QVector< QPointF > gridPositions;
+		QStaticText units;
+		QPointF unitsPosition;
+		QStaticText title;
+		QPointF titlePosition;
+	};
+
+	//! \return Drawing parameters for the radius and angles.
+	static DrawParams drawParams( const MeterSettings & s );
+	//! \return Angle of the needle for the given value.
+	static qreal needleAngle( const MeterSettings & s, const DrawParams & params, qreal v );
+	//! \return Rectangle of the value label.
+	static QRectF valueLabelRect( const MeterSettings & s, const DrawParams & params );
+	//! \return Text of the value label for the given value.
+	static QString valueText( const MeterSettings & s, qreal v );
+	//! \return Font of the value label.
+	static QFont valueFont( const MeterSettings & s, const DrawParams & params );
+	//! \return Line from ( 0, from ) to ( 0, to ) rotated by angle around the center.
+	static QLineF tickLine( qreal angle, qreal from, qreal to );
+
+	//! \return Ticks of the scale.
+	static TickGeometry ticks( const MeterSettings & s, const DrawParams & params );
+	//! \return Laid out static labels.
+	static LabelCache labels( const MeterSettings & s, const DrawParams & params,
+		const TickGeometry & ticks );
+
+	static void drawBackground( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params );
+	static void drawRanges( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params );
+	static void drawScale( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, const TickGeometry & ticks );
+	static void drawLabels( QPainter & painter, const MeterSettings & s,
+		const LabelCache & labels );
+	static void drawValueLabel( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal v );
+	//! Draw needle without hub at the given angle.
+	static void drawNeedle( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal angle );
+	//! Draw needle without hub at the given angle with the given color.
+	static void drawNeedle( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal angle, const QColor & color );
+	//! Draw hub of the needle centered at the origin.
+	static void drawHub( QPainter & painter, const MeterSettings & s );
+
+	//! \return Rectangle of the history trail relative to the face.
+	static QRectF trailRect( const MeterSettings & s );
+	//! \return Line of peak or trough marker at the angle, relative to the center.
+	static QLineF markerLine( const MeterSettings & s, const DrawParams & params,
+		qreal angle );
+	//! \return Width of the marker's line.
+	static qreal markerWidth( const DrawParams & params );
+	//! Draw peak or trough marker at the angle centered at the origin.
+	static void drawMarker( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal angle );
+
+	//! \return Outer radius of the band of value statistics.
+	static qreal statsBandOuter( const MeterSettings & s, const DrawParams & params );
+	//! \return Inner radius of the band of value statistics.
+	static qreal statsBandInner( const MeterSettings & s, const DrawParams & params );
+	//! \return Bounding rectangle of the ring sector relative to the center.
+	static QRectF sectorRect( qreal from, qreal to, qreal inner, qreal outer );
+	/*!
+		Draw band of value statistics between angles \a from and \a to with
+		ticks at angles of quantiles centered at the origin.
+	*/
+	static void drawStatsBand( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal from, qreal to, qreal p95, qreal p99 );
+
+	//! Draw background, ranges, scale and static labels, time layers if stats given.
+	static void drawFace( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, const TickGeometry & ticks, const LabelCache & labels,
+		MeterRenderStats * stats = Q_NULLPTR );
+	//! Draw value label and needle with hub.
+	static void drawValueAndNeedle( QPainter & painter, const MeterSettings & s,
+		const DrawParams & params, qreal v );
+}; // class MeterRendererPrivate
+
+#endif // METER_RENDERER_P_HPP_INCLUDED
@@ -0,0 +1,178 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_scale_p.hpp"
+
+// Qt include.
+#include <QtMath>
+
+// C++ include.
+#include <algorithm>
+#include <cmath>
+
+
+//
+// MeterScale
+//
+
+MeterScale::MeterScale()
+	:  m_type( Linear )
+{
+}
+
+MeterScale
+MeterScale::linear()
+{
+	return MeterScale();
+}
+
+MeterScale
+MeterScale::logarithmic()
+{
+	MeterScale s;
+	s.m_type = Logarithmic;
+
+	return s;
+}
+
+MeterScale
+MeterScale::piecewise( const QVector< QPointF > & points )
+{
+	MeterScale s;
+
+	if( points.size() > 1 )
+	{
+		s.m_type = Piecewise;
+		s.m_points = points;
+
+		std::stable_sort( s.m_points.begin(), s.m_points.end(),
+			[] ( const QPointF & a, const QPointF & b ) { return a.x() < b.x(); } );
+	}
+
+	return s;
+}
+
+bool
+MeterScale::operator == ( const MeterScale & other ) const
+{
+	return ( m_type == other.m_type && m_points == other.m_points );
+}
+
+
+//
+// MeterScaleTable
+//
+
+namespace /* anonymous */ {
+
+//! Count of intervals in the table of logarithm of mantissa.
+static const int c_log2TableSize = 256;
+
+//! Base 2 logarithm of mantissa in [0.5, 1].
+struct Log2Table {
+	Log2Table()
+	{
+		for( int i = 0; i <= c_log2TableSize; ++i )
+			values[ i ] = std::log2( 0.5 + 0.5 * i / c_log2TableSize );
+	}
+
+	qreal values[ c_log2TableSize + 1 ];
+}; // struct Log2Table
+
+} /* namespace anonymous */
+
+MeterScaleTable::MeterScaleTable()
+	:  m_type( MeterScale::Linear )
+	,  m_min( 0.0 )
+	,  m_factor( 0.0 )
+{
+}
+
+MeterScaleTable::MeterScaleTable( const MeterScale & scale, qreal minValue, qreal maxValue )
+	:  m_type( scale.type() )
+	,  m_min( minValue )
+	,  m_factor( 0.0 )
+	,  m_points( scale.points() )
+{
+	if( m_type == MeterScale::Logarithmic && ( minValue <= 0.0 || maxValue <= minValue ) )
+		m_type = MeterScale::Linear;
+
+	if( m_type == MeterScale::Logarithmic )
+	{
+		m_min = log2( minValue );
+		m_factor = 1.0 / ( log2( maxValue ) - m_min );
+	}
+	else if( m_type == MeterScale::Linear && maxValue > minValue )
+		m_factor = 1.0 / ( maxValue - minValue );
+}
+
+qreal
+MeterScaleTable::fraction( qreal v ) const
+{
+	switch( m_type )
+	{
+		case MeterScale::Logarithmic :
+			return ( v > 0.0 ? qBound( 0.0, ( log2( v ) - m_min ) * m_factor, 1.0 ) : 0.0 );
+
+		case MeterScale::Piecewise :
+		{
+			const auto it = std::upper_bound( m_points.cbegin(), m_points.cend(), v,
+				[] ( qreal x, const QPointF & p ) { return x < p.x(); } );
+
+			if( it == m_points.cbegin() )
+				return qBound( 0.0, m_points.first().y(), 1.0 );
+			else if( it == m_points.cend() )
+				return qBound( 0.0, m_points.last().y(), 1.0 );
+
+			const QPointF & p1 = *( it - 1 );
+			const QPointF & p2 = *it;
+
+			return qBound( 0.0, p1.y() + ( p2.y() - p1.y() ) *
+				( v - p1.x() ) / ( p2.x() - p1.x() ), 1.0 );
+		}
+
+		default :
+			return ( v - m_min ) * m_factor;
+	}
+}
+
+qreal
+MeterScaleTable::log2( qreal v )
+{
+	static const Log2Table table;
+
+	int exponent = 0;
+	const qreal mantissa = std::frexp( v, &exponent );
+	const qreal x = ( mantissa - 0.5 ) * 2.0 * c_log2TableSize;
+	const int i = qMin( static_cast< int > ( x ), c_log2TableSize - 1 );
+
+	return exponent + table.values[ i ] +
+		( table.values[ i + 1 ] - table.values[ i ] ) * ( x - i );
+}
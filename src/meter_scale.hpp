@@ -0,0 +1,89 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_SCALE_HPP_INCLUDED
+#define METER_SCALE_HPP_INCLUDED
+
+// Qt include.
+#include <QPointF>
+#include <QVector>
+
+
+//
+// MeterScale
+//
+
+/*!
+	\brief Mapping of values to the arc of the scale.
+
+	Linear scale is the default one. Logarithmic scale needs positive
+	minimum value, otherwise it's drawn as linear, its grid is drawn at
+	powers of 10 and minor ticks at their multiples, steps of the meter
+	are ignored. Piecewise scale maps values linearly between points,
+	where x is a value and y is a fraction of the arc from 0 to 1.
+*/
+class MeterScale Q_DECL_FINAL {
+public:
+	enum Type {
+		Linear,
+		Logarithmic,
+		Piecewise
+	}; // enum Type
+
+	MeterScale();
+
+	static MeterScale linear();
+	static MeterScale logarithmic();
+	//! \a points may go in any order, fractions should not decrease with values.
+	static MeterScale piecewise( const QVector< QPointF > & points );
+
+	Type type() const
+	{
+		return m_type;
+	}
+
+	//! \return Points of piecewise scale.
+	const QVector< QPointF > & points() const
+	{
+		return m_points;
+	}
+
+	bool operator == ( const MeterScale & other ) const;
+	bool operator != ( const MeterScale & other ) const
+	{
+		return !( *this == other );
+	}
+
+private:
+	Type m_type;
+	QVector< QPointF > m_points;
+}; // class MeterScale
+
+#endif // METER_SCALE_HPP_INCLUDED
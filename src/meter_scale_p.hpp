@@ -0,0 +1,74 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_SCALE_P_HPP_INCLUDED
+#define METER_SCALE_P_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_scale.hpp"
+
+
+//
+// MeterScaleTable
+//
+
+/*!
+	\brief Mapping of the scale prepared for the range of the meter.
+
+	Logarithm is taken from a precomputed table of the mantissa with
+	linear interpolation, so no transcendental function is called per
+	value. Table is built once and shared by all scales.
+*/
+class MeterScaleTable Q_DECL_FINAL {
+public:
+	MeterScaleTable();
+	MeterScaleTable( const MeterScale & scale, qreal minValue, qreal maxValue );
+
+	//! \return Effective type of the scale.
+	MeterScale::Type type() const
+	{
+		return m_type;
+	}
+
+	//! \return Fraction of the arc for the value, from 0 to 1.
+	qreal fraction( qreal v ) const;
+
+	//! \return Approximate base 2 logarithm of positive value.
+	static qreal log2( qreal v );
+
+private:
+	MeterScale::Type m_type;
+	qreal m_min;
+	//! Multiplier of the offset from the minimum, in logarithms for logarithmic scale.
+	qreal m_factor;
+	QVector< QPointF > m_points;
+}; // class MeterScaleTable
+
+#endif // METER_SCALE_P_HPP_INCLUDED
@@ -0,0 +1,243 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_stats.hpp"
+
+// Qt include.
+#include <QtMath>
+
+// C++ include.
+#include <algorithm>
+
+
+//
+// MeterQuantile
+//
+
+MeterQuantile::MeterQuantile( qreal p )
+	:  m_p( qBound( 0.0, p, 1.0 ) )
+{
+	reset();
+}
+
+void
+MeterQuantile::reset()
+{
+	m_count = 0;
+
+	for( int i = 0; i < 5; ++i )
+	{
+		m_q[ i ] = 0.0;
+		m_n[ i ] = i + 1;
+	}
+
+	m_desired[ 0 ] = 1.0;
+	m_desired[ 1 ] = 1.0 + 2.0 * m_p;
+	m_desired[ 2 ] = 1.0 + 4.0 * m_p;
+	m_desired[ 3 ] = 3.0 + 2.0 * m_p;
+	m_desired[ 4 ] = 5.0;
+
+	m_increment[ 0 ] = 0.0;
+	m_increment[ 1 ] = m_p / 2.0;
+	m_increment[ 2 ] = m_p;
+	m_increment[ 3 ] = ( 1.0 + m_p ) / 2.0;
+	m_increment[ 4 ] = 1.0;
+}
+
+void
+MeterQuantile::add( qreal x )
+{
+	// The first five observations become initial markers.
+	if( m_count < 5 )
+	{
+		m_q[ m_count++ ] = x;
+
+		if( m_count == 5 )
+			std::sort( m_q, m_q + 5 );
+
+		return;
+	}
+
+	++m_count;
+
+	int k = 0;
+
+	if( x < m_q[ 0 ] )
+	{
+		m_q[ 0 ] = x;
+		k = 0;
+	}
+	else if( x >= m_q[ 4 ] )
+	{
+		m_q[ 4 ] = x;
+		k = 3;
+	}
+	else
+	{
+		while( x >= m_q[ k + 1 ] )
+			++k;
+	}
+
+	for( int i = k + 1; i < 5; ++i )
+		++m_n[ i ];
+
+	for( int i = 0; i < 5; ++i )
+		m_desired[ i ] += m_increment[ i ];
+
+	// Adjust heights of middle markers when they are off their desired positions.
+	for( int i = 1; i < 4; ++i )
+	{
+		const qreal d = m_desired[ i ] - m_n[ i ];
+
+		if( ( d >= 1.0 && m_n[ i + 1 ] - m_n[ i ] > 1 ) ||
+			( d <= -1.0 && m_n[ i - 1 ] - m_n[ i ] < -1 ) )
+		{
+			const int s = ( d > 0.0 ? 1 : -1 );
+			const qreal q = parabolic( i, s );
+
+			if( m_q[ i - 1 ] < q && q < m_q[ i + 1 ] )
+				m_q[ i ] = q;
+			else
+				m_q[ i ] = linear( i, s );
+
+			m_n[ i ] += s;
+		}
+	}
+}
+
+qreal
+MeterQuantile::parabolic( int i, int d ) const
+{
+	const qreal n0 = m_n[ i - 1 ];
+	const qreal n1 = m_n[ i ];
+	const qreal n2 = m_n[ i + 1 ];
+
+	return m_q[ i ] + d / ( n2 - n0 ) *
+		( ( n1 - n0 + d ) * ( m_q[ i + 1 ] - m_q[ i ] ) / ( n2 - n1 ) +
+		( n2 - n1 - d ) * ( m_q[ i ] - m_q[ i - 1 ] ) / ( n1 - n0 ) );
+}
+
+qreal
+MeterQuantile::linear( int i, int d ) const
+{
+	return m_q[ i ] + d * ( m_q[ i + d ] - m_q[ i ] ) /
+		qreal( m_n[ i + d ] - m_n[ i ] );
+}
+
+qreal
+MeterQuantile::value() const
+{
+	if( m_count >= 5 )
+		return m_q[ 2 ];
+	else if( m_count == 0 )
+		return 0.0;
+
+	// Too few observations for markers, take it from sorted ones.
+	qreal q[ 5 ];
+	std::copy( m_q, m_q + m_count, q );
+	std::sort( q, q + m_count );
+
+	return q[ qMin( m_count - 1, static_cast< qint64 > ( m_p * m_count ) ) ];
+}
+
+
+//
+// MeterValueStats
+//
+
+MeterValueStats::MeterValueStats()
+	:  m_count( 0 )
+	,  m_mean( 0.0 )
+	,  m_m2( 0.0 )
+	,  m_weight( 0.0 )
+	,  m_decay( 1.0 )
+	,  m_halfLife( 0 )
+	,  m_window( 0 )
+	,  m_p95( 0.95 )
+	,  m_p99( 0.99 )
+{
+}
+
+void
+MeterValueStats::add( qreal v )
+{
+	if( m_window > 0 && m_count >= m_window )
+		reset();
+
+	++m_count;
+
+	// Weighted Welford's update, without decay it is the classic one.
+	m_weight = m_weight * m_decay + 1.0;
+
+	const qreal delta = v - m_mean;
+
+	m_mean += delta / m_weight;
+	m_m2 = m_m2 * m_decay + delta * ( v - m_mean );
+
+	m_p95.add( v );
+	m_p99.add( v );
+}
+
+void
+MeterValueStats::reset()
+{
+	m_count = 0;
+	m_mean = 0.0;
+	m_m2 = 0.0;
+	m_weight = 0.0;
+
+	m_p95.reset();
+	m_p99.reset();
+}
+
+qreal
+MeterValueStats::variance() const
+{
+	return ( m_weight > 0.0 ? qMax( 0.0, m_m2 / m_weight ) : 0.0 );
+}
+
+qreal
+MeterValueStats::standardDeviation() const
+{
+	return qSqrt( variance() );
+}
+
+void
+MeterValueStats::setHalfLife( int samples )
+{
+	m_halfLife = qMax( 0, samples );
+	m_decay = ( m_halfLife > 0 ? qPow( 0.5, 1.0 / m_halfLife ) : 1.0 );
+}
+
+void
+MeterValueStats::setWindow( int samples )
+{
+	m_window = qMax( 0, samples );
+}
@@ -0,0 +1,162 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_STATS_HPP_INCLUDED
+#define METER_STATS_HPP_INCLUDED
+
+// Qt include.
+#include <QtGlobal>
+
+
+//
+// MeterQuantile
+//
+
+/*!
+	\brief Streaming estimation of a quantile with P-square algorithm.
+
+	Keeps five markers only, so memory and cost of an update are constant
+	regardless of count of observations.
+*/
+class MeterQuantile Q_DECL_FINAL {
+public:
+	//! \a p is the quantile to estimate in ( 0, 1 ).
+	explicit MeterQuantile( qreal p );
+
+	qreal probability() const
+	{
+		return m_p;
+	}
+
+	//! Add observation.
+	void add( qreal x );
+	//! Forget all observations.
+	void reset();
+
+	//! \return Estimated quantile, 0 if there are no observations.
+	qreal value() const;
+
+private:
+	//! \return Parabolic prediction of the marker's height.
+	qreal parabolic( int i, int d ) const;
+	//! \return Linear prediction of the marker's height.
+	qreal linear( int i, int d ) const;
+
+private:
+	qreal m_p;
+	//! Heights of markers.
+	qreal m_q[ 5 ];
+	//! Desired positions of markers.
+	qreal m_desired[ 5 ];
+	//! Increments of desired positions.
+	qreal m_increment[ 5 ];
+	//! Actual positions of markers.
+	qint64 m_n[ 5 ];
+	qint64 m_count;
+}; // class MeterQuantile
+
+
+//
+// MeterValueStats
+//
+
+/*!
+	\brief Incremental statistics of values of the meter.
+
+	Mean and variance use Welford's method and optionally decay
+	exponentially with the given half-life, p95 and p99 are estimated
+	with MeterQuantile. With a window everything is reset after the
+	given count of samples. Each update is O( 1 ) and nothing is allocated.
+*/
+class MeterValueStats Q_DECL_FINAL {
+public:
+	MeterValueStats();
+
+	//! Add value.
+	void add( qreal v );
+	//! Forget all values.
+	void reset();
+
+	//! \return Count of values since the last reset.
+	qint64 count() const
+	{
+		return m_count;
+	}
+
+	qreal mean() const
+	{
+		return m_mean;
+	}
+
+	qreal variance() const;
+	qreal standardDeviation() const;
+
+	qreal p95() const
+	{
+		return m_p95.value();
+	}
+
+	qreal p99() const
+	{
+		return m_p99.value();
+	}
+
+	int halfLife() const
+	{
+		return m_halfLife;
+	}
+
+	//! Set half-life of mean and variance in samples, 0 means no decay.
+	void setHalfLife( int samples );
+
+	int window() const
+	{
+		return m_window;
+	}
+
+	//! Set count of samples after which statistics reset, 0 means never.
+	void setWindow( int samples );
+
+private:
+	qint64 m_count;
+	qreal m_mean;
+	//! Sum of weighted squared differences from the mean.
+	qreal m_m2;
+	//! Sum of weights, equals to count without decay.
+	qreal m_weight;
+	//! Weight of the previous values on each update.
+	qreal m_decay;
+	int m_halfLife;
+	int m_window;
+	MeterQuantile m_p95;
+	MeterQuantile m_p99;
+}; // class MeterValueStats
+
+#endif // METER_STATS_HPP_INCLUDED
@@ -0,0 +1,385 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_style_p.hpp"
+
+// Qt include.
+#include <QPainter>
+#include <QtMath>
+#include <QFontMetricsF>
+#include <QPen>
+
+
+//
+// MeterGlyphAtlas
+//
+
+int
+MeterGlyphAtlas::index( QChar c )
+{
+	if( c.isDigit() && c.unicode() <= '9' )
+		return c.unicode() - '0';
+	else if( c == QLatin1Char( '.' ) )
+		return 10;
+	else if( c == QLatin1Char( '-' ) )
+		return 11;
+	else
+		return -1;
+}
+
+
+//
+// MeterStyleData
+//
+
+MeterStyleData::MeterStyleData()
+	:  m_paramsValid( false )
+	,  m_ticksValid( false )
+	,  m_bandsValid( false )
+{
+}
+
+MeterStyleData::MeterStyleData( const MeterSettings & s )
+	:  settings( s )
+	,  m_paramsValid( false )
+	,  m_ticksValid( false )
+	,  m_bandsValid( false )
+{
+}
+
+MeterStyleData::MeterStyleData( const MeterStyleData & other )
+	:  QSharedData( other )
+	,  settings( other.settings )
+	,  m_paramsValid( false )
+	,  m_ticksValid( false )
+	,  m_bandsValid( false )
+{
+}
+
+MeterSettings &
+MeterStyleData::edit( MeterStyle & style, int caches )
+{
+	// Detaches if shared, otherwise caches of the only owner are outdated.
+	style.d->clearCaches( caches );
+
+	return style.d->settings;
+}
+
+void
+MeterStyleData::clearCaches( int caches )
+{
+	if( caches & Params )
+		m_paramsValid = false;
+
+	if( caches & Ticks )
+		m_ticksValid = false;
+
+	if( caches & Bands )
+		m_bandsValid = false;
+
+	if( caches & Labels )
+		m_labels = LabelCache();
+
+	if( caches & Face )
+		m_faces.clear();
+
+	if( caches & Atlas )
+		m_atlases.clear();
+
+	if( caches & Sprites )
+		m_sprites.clear();
+}
+
+const MeterStyleData::DrawParams &
+MeterStyleData::drawParams() const
+{
+	if( !m_paramsValid )
+	{
+		m_params = MeterRendererPrivate::drawParams( settings );
+
+		m_paramsValid = true;
+	}
+
+	return m_params;
+}
+
+const MeterStyleData::TickGeometry &
+MeterStyleData::ticks() const
+{
+	if( !m_ticksValid )
+	{
+		m_ticks = MeterRendererPrivate::ticks( settings, drawParams() );
+
+		m_ticksValid = true;
+	}
+
+	return m_ticks;
+}
+
+const MeterStyleData::LabelCache &
+MeterStyleData::labels( qreal dpr ) const
+{
+	if( !qFuzzyCompare( m_labels.dpr, dpr ) )
+	{
+		m_labels = MeterRendererPrivate::labels( settings, drawParams(), ticks() );
+		m_labels.dpr = dpr;
+	}
+
+	return m_labels;
+}
+
+const QPixmap &
+MeterStyleData::face( qreal dpr, MeterRenderStats * stats ) const
+{
+	for( const QPixmap & f : qAsConst( m_faces ) )
+	{
+		if( qFuzzyCompare( f.devicePixelRatio(), dpr ) )
+			return f;
+	}
+
+	const int size = qCeil( ( settings.radius * 2 + 2 ) * dpr );
+
+	QPixmap face( size, size );
+	face.setDevicePixelRatio( dpr );
+	face.fill( Qt::transparent );
+
+	{
+		QPainter p( &face );
+		p.setRenderHint( QPainter::Antialiasing );
+		p.translate( 1.0, 1.0 );
+
+		MeterRendererPrivate::drawFace( p, settings,
+			drawParams(), ticks(), labels( dpr ), stats );
+	}
+
+	if( stats )
+		++stats->faceRebuilds;
+
+	m_faces.append( face );
+
+	return m_faces.last();
+}
+
+const MeterGlyphAtlas &
+MeterStyleData::atlas( qreal dpr ) const
+{
+	for( const MeterGlyphAtlas & a : qAsConst( m_atlases ) )
+	{
+		if( qFuzzyCompare( a.dpr, dpr ) )
+			return a;
+	}
+
+	static const char c_chars[ MeterGlyphAtlas::c_size + 1 ] = "0123456789.-";
+
+	MeterGlyphAtlas atlas;
+	atlas.dpr = dpr;
+	atlas.font = MeterRendererPrivate::valueFont( settings, drawParams() );
+
+	const QFontMetricsF fm( atlas.font );
+	const qreal height = qCeil( fm.height() );
+	qreal width = 0.0;
+
+	for( int i = 0; i < MeterGlyphAtlas::c_size; ++i )
+	{
+#if QT_VERSION >= QT_VERSION_CHECK( 5, 11, 0 )
+		atlas.advances[ i ] = fm.horizontalAdvance( QLatin1Char( c_chars[ i ] ) );
+#else
+		atlas.advances[ i ] = fm.width( QLatin1Char( c_chars[ i ] ) );
+#endif
+		atlas.rects[ i ] = QRectF( width, 0.0,
+			qCeil( atlas.advances[ i ] ) + atlas.padding * 2, height );
+		width += atlas.rects[ i ].width();
+	}
+
+	atlas.pixmap = QPixmap( qCeil( width * dpr ), qCeil( height * dpr ) );
+	atlas.pixmap.setDevicePixelRatio( dpr );
+	atlas.pixmap.fill( Qt::transparent );
+
+	{
+		QPainter p( &atlas.pixmap );
+		p.setFont( atlas.font );
+		p.setPen( settings.textColor );
+
+		for( int i = 0; i < MeterGlyphAtlas::c_size; ++i )
+		{
+			p.drawText( QPointF( atlas.rects[ i ].x() + atlas.padding, fm.ascent() ),
+				QString( QLatin1Char( c_chars[ i ] ) ) );
+
+			atlas.rects[ i ] = QRectF( atlas.rects[ i ].topLeft() * dpr,
+				atlas.rects[ i ].size() * dpr );
+		}
+	}
+
+	m_atlases.append( atlas );
+
+	return m_atlases.last();
+}
+
+MeterNeedleSprites &
+MeterStyleData::sprites( int angleSteps, qreal dpr ) const
+{
+	// Meters sharing the style may differ in steps and screens.
+	for( const QSharedPointer< MeterNeedleSprites > & s : qAsConst( m_sprites ) )
+	{
+		if( s->angleSteps == angleSteps && qFuzzyCompare( s->dpr, dpr ) )
+			return *s;
+	}
+
+	QSharedPointer< MeterNeedleSprites > sprites(
+		new MeterNeedleSprites( angleSteps, dpr ) );
+
+	const qreal r = settings.radius / 10.0 + 1.0;
+	const int size = qCeil( r * 2.0 * dpr );
+
+	sprites->hub = QPixmap( size, size );
+	sprites->hub.setDevicePixelRatio( dpr );
+	sprites->hub.fill( Qt::transparent );
+	sprites->hubOffset = QPointF( -r, -r );
+
+	{
+		QPainter p( &sprites->hub );
+		p.setRenderHint( QPainter::Antialiasing );
+		p.translate( r, r );
+		MeterRendererPrivate::drawHub( p, settings );
+	}
+
+	m_sprites.append( sprites );
+
+	return *m_sprites.last();
+}
+
+const MeterNeedleSprite *
+MeterStyleData::needleSprite( int angleSteps, qreal dpr, int step ) const
+{
+	MeterNeedleSprites & s = sprites( angleSteps, dpr );
+
+	const MeterNeedleSprite * cached = s.needles.object( step );
+
+	if( cached )
+		return cached;
+
+	const qreal angle = step * 360.0 / angleSteps;
+	const qreal w = settings.radius / 75.0;
+	const QLineF line = MeterRendererPrivate::tickLine( angle,
+		settings.radius - drawParams().margin,
+		- settings.radius / 10.0 * 2.0 );
+	const QRectF rect = QRectF( line.p1(), line.p2() ).normalized()
+		.adjusted( -w - 1.0, -w - 1.0, w + 1.0, w + 1.0 );
+
+	MeterNeedleSprite * sprite = new MeterNeedleSprite;
+	sprite->offset = rect.topLeft();
+	sprite->pixmap = QPixmap( qCeil( rect.width() * dpr ), qCeil( rect.height() * dpr ) );
+	sprite->pixmap.setDevicePixelRatio( dpr );
+	sprite->pixmap.fill( Qt::transparent );
+
+	{
+		QPainter p( &sprite->pixmap );
+		p.setRenderHint( QPainter::Antialiasing );
+		p.translate( -rect.topLeft() );
+		p.setPen( QPen( settings.needleColor, w ) );
+		p.drawLine( line );
+	}
+
+	const int cost = qMax( 1, sprite->pixmap.width() * sprite->pixmap.height() * 4 / 1024 );
+
+	// Cache takes ownership, sprite may be deleted right away if it's too big.
+	s.needles.insert( step, sprite, cost );
+
+	return s.needles.object( step );
+}
+
+const MeterThresholdIndex &
+MeterStyleData::bands() const
+{
+	if( !m_bandsValid )
+	{
+		m_bands.rebuild( settings.ranges );
+
+		m_bandsValid = true;
+	}
+
+	return m_bands;
+}
+
+
+//
+// MeterStyle
+//
+
+MeterStyle::MeterStyle()
+	:  d( new MeterStyleData )
+{
+}
+
+MeterStyle::MeterStyle( const MeterSettings & settings )
+	:  d( new MeterStyleData( settings ) )
+{
+}
+
+MeterStyle::MeterStyle( const MeterStyle & other )
+	:  d( other.d )
+{
+}
+
+MeterStyle &
+MeterStyle::operator = ( const MeterStyle & other )
+{
+	d = other.d;
+
+	return *this;
+}
+
+MeterStyle::~MeterStyle()
+{
+}
+
+const MeterSettings &
+MeterStyle::settings() const
+{
+	return d->settings;
+}
+
+MeterSettings &
+MeterStyle::editSettings()
+{
+	return MeterStyleData::edit( *this, MeterStyleData::AllCaches );
+}
+
+void
+MeterStyle::setSettings( const MeterSettings & settings )
+{
+	editSettings() = settings;
+}
+
+bool
+MeterStyle::isSharedWith( const MeterStyle & other ) const
+{
+	return ( d == other.d );
+}
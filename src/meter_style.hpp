@@ -0,0 +1,78 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_STYLE_HPP_INCLUDED
+#define METER_STYLE_HPP_INCLUDED
+
+// Qt include.
+#include <QSharedDataPointer>
+
+// Widgets include.
+#include "meter_renderer.hpp"
+
+
+//
+// MeterStyle
+//
+
+class MeterStyleData;
+
+/*!
+	\brief Implicitly shared look of the meter.
+
+	Meters with the same style share settings as well as rendered face,
+	ticks, labels, glyphs of the value label and needle sprites. Style
+	is copied on write, modification drops caches of the copy only.
+	Caches are built and used in GUI thread.
+*/
+class MeterStyle Q_DECL_FINAL {
+public:
+	MeterStyle();
+	explicit MeterStyle( const MeterSettings & settings );
+	MeterStyle( const MeterStyle & other );
+	MeterStyle & operator = ( const MeterStyle & other );
+	~MeterStyle();
+
+	//! \return Settings of the style.
+	const MeterSettings & settings() const;
+	//! \return Settings for modification, detaches the style.
+	MeterSettings & editSettings();
+	void setSettings( const MeterSettings & settings );
+
+	//! \return Do both styles share the same data.
+	bool isSharedWith( const MeterStyle & other ) const;
+
+private:
+	friend class MeterStyleData;
+
+	QSharedDataPointer< MeterStyleData > d;
+}; // class MeterStyle
+
+#endif // METER_STYLE_HPP_INCLUDED
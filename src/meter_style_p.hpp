@@ -0,0 +1,199 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_STYLE_P_HPP_INCLUDED
+#define METER_STYLE_P_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_style.hpp"
+#include "meter_renderer_p.hpp"
+#include "meter_thresholds_p.hpp"
+
+// Qt include.
+#include <QSharedData>
+#include <QPixmap>
+#include <QCache>
+#include <QSharedPointer>
+
+
+//
+// MeterGlyphAtlas
+//
+
+//! Pre-rendered glyphs of the value label.
+struct MeterGlyphAtlas {
+	MeterGlyphAtlas()
+		:  dpr( 0.0 )
+		,  padding( 2 )
+	{
+	}
+
+	//! Count of characters in the atlas.
+	static const int c_size = 12;
+
+	//! \return Index of the character in the atlas or -1.
+	static int index( QChar c );
+
+	QPixmap pixmap;
+	QFont font;
+	qreal dpr;
+	//! Horizontal padding of each glyph in the pixmap.
+	int padding;
+	//! Rectangles of glyphs in pixels of the pixmap.
+	QRectF rects[ c_size ];
+	qreal advances[ c_size ];
+}; // struct MeterGlyphAtlas
+
+
+//
+// MeterNeedleSprites
+//
+
+//! Pre-rendered needle at the quantized angle.
+struct MeterNeedleSprite {
+	QPixmap pixmap;
+	//! Position of the pixmap relative to the center.
+	QPointF offset;
+}; // struct MeterNeedleSprite
+
+//! Pre-rendered hub and needles.
+struct MeterNeedleSprites {
+	MeterNeedleSprites( int steps, qreal r )
+		:  angleSteps( steps )
+		,  dpr( r )
+	{
+		needles.setMaxCost( c_cacheSize );
+	}
+
+	//! Maximum size of cached needle sprites in kilobytes.
+	static const int c_cacheSize = 16 * 1024;
+
+	int angleSteps;
+	qreal dpr;
+	QPixmap hub;
+	//! Position of the hub's pixmap relative to the center.
+	QPointF hubOffset;
+	//! Needles by quantized angle index.
+	QCache< int, MeterNeedleSprite > needles;
+}; // struct MeterNeedleSprites
+
+
+//
+// MeterStyleData
+//
+
+/*!
+	Shared data of MeterStyle. Caches are built lazily from settings,
+	as settings of shared data never change caches are never outdated.
+*/
+class MeterStyleData
+:  public QSharedData
+{
+public:
+	typedef MeterRendererPrivate::DrawParams DrawParams;
+	typedef MeterRendererPrivate::TickGeometry TickGeometry;
+	typedef MeterRendererPrivate::LabelCache LabelCache;
+
+	//! Caches built from settings.
+	enum Cache {
+		//! Settings drawn on each paint only.
+		NoCaches = 0x00,
+		Params = 0x01,
+		Ticks = 0x02,
+		Labels = 0x04,
+		Face = 0x08,
+		Atlas = 0x10,
+		Sprites = 0x20,
+		Bands = 0x40,
+		//! Static text rendered into the face.
+		Text = Labels | Face,
+		//! Ticks and grid labels of the scale.
+		Grid = Ticks | Text,
+		//! Everything laid out on the arc of the scale.
+		Geometry = Params | Grid,
+		AllCaches = Geometry | Atlas | Sprites | Bands
+	}; // enum Cache
+
+	MeterStyleData();
+	explicit MeterStyleData( const MeterSettings & s );
+	//! Copies settings only, caches of the copy are built anew.
+	MeterStyleData( const MeterStyleData & other );
+
+	static const MeterStyleData * get( const MeterStyle & style )
+	{
+		return style.d.constData();
+	}
+
+	/*!
+		\return Settings for modification, detaches the style. Only the
+		given caches of Cache are dropped, so the change must not affect
+		the others.
+	*/
+	static MeterSettings & edit( MeterStyle & style, int caches );
+
+	//! Drop the given caches of Cache.
+	void clearCaches( int caches = AllCaches );
+
+	//! \return Drawing parameters with the scale table.
+	const DrawParams & drawParams() const;
+	//! \return Ticks of the scale.
+	const TickGeometry & ticks() const;
+	//! \return Laid out static labels.
+	const LabelCache & labels( qreal dpr ) const;
+	/*!
+		\return Background, ranges, scale and static labels, one per
+		device pixel ratio. Rebuild is counted in stats if given.
+	*/
+	const QPixmap & face( qreal dpr, MeterRenderStats * stats = Q_NULLPTR ) const;
+	//! \return Glyph atlas of the value label, one per device pixel ratio.
+	const MeterGlyphAtlas & atlas( qreal dpr ) const;
+	//! \return Needle sprites, one per count of steps and device pixel ratio.
+	MeterNeedleSprites & sprites( int angleSteps, qreal dpr ) const;
+	//! \return Needle sprite for the quantized angle index, may be null.
+	const MeterNeedleSprite * needleSprite( int angleSteps, qreal dpr, int step ) const;
+	//! \return Sorted non-overlapping bands of threshold ranges.
+	const MeterThresholdIndex & bands() const;
+
+	MeterSettings settings;
+
+private:
+	mutable bool m_paramsValid;
+	mutable bool m_ticksValid;
+	mutable bool m_bandsValid;
+	mutable DrawParams m_params;
+	mutable TickGeometry m_ticks;
+	mutable LabelCache m_labels;
+	mutable QVector< QPixmap > m_faces;
+	mutable QVector< MeterGlyphAtlas > m_atlases;
+	mutable QVector< QSharedPointer< MeterNeedleSprites > > m_sprites;
+	mutable MeterThresholdIndex m_bands;
+}; // class MeterStyleData
+
+#endif // METER_STYLE_P_HPP_INCLUDED
@@ -0,0 +1,95 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_thresholds_p.hpp"
+
+// C++ include.
+#include <algorithm>
+
+
+//
+// MeterThresholdIndex
+//
+
+void
+MeterThresholdIndex::rebuild( const QMultiMap< int, MeterRange > & ranges )
+{
+	static const qreal c_epsilon = 0.000001;
+
+	QVector< qreal > points;
+	points.reserve( ranges.size() * 2 );
+
+	for( auto it = ranges.cbegin(), last = ranges.cend(); it != last; ++it )
+	{
+		points.append( it.value().start - c_epsilon );
+		points.append( it.value().stop );
+	}
+
+	std::sort( points.begin(), points.end() );
+	points.erase( std::unique( points.begin(), points.end() ), points.end() );
+
+	m_bands.clear();
+
+	// Each elementary interval belongs to the first range covering it,
+	// as ranges are checked in order of threshold indexes.
+	for( int i = 0; i < points.size() - 1; ++i )
+	{
+		const qreal lo = points.at( i );
+		const qreal hi = points.at( i + 1 );
+
+		for( auto it = ranges.cbegin(), last = ranges.cend(); it != last; ++it )
+		{
+			if( it.value().start - c_epsilon <= lo && it.value().stop >= hi )
+			{
+				if( !m_bands.isEmpty() && m_bands.last().stop == lo &&
+					m_bands.last().thresholdIndex == it.key() )
+						m_bands.last().stop = hi;
+				else
+					m_bands.append( { lo, hi, it.key() } );
+
+				break;
+			}
+		}
+	}
+}
+
+int
+MeterThresholdIndex::find( qreal v ) const
+{
+	const auto it = std::upper_bound( m_bands.cbegin(), m_bands.cend(), v,
+		[] ( qreal x, const Band & b ) { return x < b.start; } );
+
+	if( it == m_bands.cbegin() )
+		return -1;
+
+	const auto band = it - 1;
+
+	return ( v < band->stop ? static_cast< int > ( band - m_bands.cbegin() ) : -1 );
+}
@@ -0,0 +1,83 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_THRESHOLDS_P_HPP_INCLUDED
+#define METER_THRESHOLDS_P_HPP_INCLUDED
+
+// Widgets include.
+#include "meter_renderer.hpp"
+
+// Qt include.
+#include <QVector>
+
+
+//
+// MeterThresholdIndex
+//
+
+//! Sorted non-overlapping bands of threshold ranges with binary search.
+class MeterThresholdIndex {
+public:
+	//! Non-overlapping interval of the threshold, [start, stop).
+	struct Band {
+		qreal start;
+		qreal stop;
+		int thresholdIndex;
+	};
+
+	/*!
+		Rebuild bands from ranges. Where ranges overlap the one with
+		less threshold index wins, as it's found first in the map.
+	*/
+	void rebuild( const QMultiMap< int, MeterRange > & ranges );
+
+	//! \return Index of the band containing the value or -1.
+	int find( qreal v ) const;
+
+	bool isEmpty() const
+	{
+		return m_bands.isEmpty();
+	}
+
+	int size() const
+	{
+		return m_bands.size();
+	}
+
+	const Band & at( int i ) const
+	{
+		return m_bands.at( i );
+	}
+
+private:
+	QVector< Band > m_bands;
+}; // class MeterThresholdIndex
+
+#endif // METER_THRESHOLDS_P_HPP_INCLUDED
@@ -0,0 +1,102 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "meter_window_p.hpp"
+
+// Qt include.
+#include <QWidget>
+#include <QEvent>
+#include <QHash>
+
+
+//
+// MeterWindowWatcher
+//
+
+typedef QHash< QWidget*, MeterWindowWatcher* > MeterWindowWatchers;
+
+Q_GLOBAL_STATIC( MeterWindowWatchers, g_watchers )
+
+MeterWindowWatcher::MeterWindowWatcher( QWidget * window )
+	:  QObject( window )
+	,  m_window( window )
+{
+	m_window->installEventFilter( this );
+}
+
+MeterWindowWatcher::~MeterWindowWatcher()
+{
+	if( g_watchers.exists() && g_watchers->value( m_window ) == this )
+		g_watchers->remove( m_window );
+}
+
+MeterWindowWatcher *
+MeterWindowWatcher::watch( QWidget * window, Client * c )
+{
+	MeterWindowWatcher * w = g_watchers->value( window );
+
+	if( !w )
+	{
+		w = new MeterWindowWatcher( window );
+
+		g_watchers->insert( window, w );
+	}
+
+	if( !w->m_clients.contains( c ) )
+		w->m_clients.append( c );
+
+	return w;
+}
+
+void
+MeterWindowWatcher::remove( Client * c )
+{
+	m_clients.removeOne( c );
+
+	if( m_clients.isEmpty() )
+	{
+		g_watchers->remove( m_window );
+		m_window->removeEventFilter( this );
+
+		deleteLater();
+	}
+}
+
+bool
+MeterWindowWatcher::eventFilter( QObject * watched, QEvent * e )
+{
+	if( watched == m_window && e->type() == QEvent::WindowStateChange )
+	{
+		for( Client * c : qAsConst( m_clients ) )
+			c->windowStateChanged();
+	}
+
+	return QObject::eventFilter( watched, e );
+}
@@ -0,0 +1,92 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef METER_WINDOW_P_HPP_INCLUDED
+#define METER_WINDOW_P_HPP_INCLUDED
+
+// Qt include.
+#include <QObject>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QWidget;
+QT_END_NAMESPACE
+
+
+//
+// MeterWindowWatcher
+//
+
+/*!
+	Watcher of the top level window shared by all meters in it.
+	It's a child of the window and is the only event filter on it,
+	clients are notified on window state changes only.
+*/
+class MeterWindowWatcher Q_DECL_FINAL
+	:  public QObject
+{
+public:
+	//! Object notified on state changes of the window.
+	class Client {
+	public:
+		virtual ~Client()
+		{
+		}
+
+		//! Window was minimized, maximized or restored.
+		virtual void windowStateChanged() = 0;
+	}; // class Client
+
+	//! \return Watcher of the window the client is added to.
+	static MeterWindowWatcher * watch( QWidget * window, Client * c );
+
+	//! Stop notifying the client, the watcher is deleted when there are no clients.
+	void remove( Client * c );
+
+	//! \return Watched window.
+	QWidget * window() const
+	{
+		return m_window;
+	}
+
+protected:
+	bool eventFilter( QObject * watched, QEvent * e ) Q_DECL_OVERRIDE;
+
+private:
+	explicit MeterWindowWatcher( QWidget * window );
+	~MeterWindowWatcher();
+
+	Q_DISABLE_COPY( MeterWindowWatcher )
+
+	QWidget * m_window;
+	QVector< Client* > m_clients;
+}; // class MeterWindowWatcher
+
+#endif // METER_WINDOW_P_HPP_INCLUDED
@@ -0,0 +1,527 @@
+
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Widgets include.
+#include <Widgets/Meter>
+#include <Widgets/MeterRenderer>
+#include <Widgets/MeterPanel>
+#include <Widgets/MeterBank>
+
+// Widgets private include.
+#include "meter_renderer_p.hpp"
+#include "meter_panel_p.hpp"
+
+// Qt include.
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+
+//
+// MeterBenchmark
+//
+
+/*!
+	Benchmarks of the meter. Run with -o file,xml or -o file,csv to get
+	machine-readable results, with -platform offscreen to run without display.
+*/
+class MeterBenchmark Q_DECL_FINAL
+	:  public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void paint_data();
+	void paint();
+	void setValue_data();
+	void setValue();
+	void thresholdFired_data();
+	void thresholdFired();
+	void postValue();
+	void renderFace_data();
+	void renderFace();
+	void drawLabels_data();
+	void drawLabels();
+	void renderBatch_data();
+	void renderBatch();
+	void memoryPerGauge_data();
+	void memoryPerGauge();
+	void bankSetValues_data();
+	void bankSetValues();
+}; // class MeterBenchmark
+
+//! Configure meter as in the example.
+static void
+setupMeter( Meter & m, uint radius, qreal scaleStep )
+{
+	m.setMinValue( 0.0 );
+	m.setMaxValue( 220.0 );
+	m.setLabel( QStringLiteral( "speed" ) );
+	m.setUnitsLabel( QStringLiteral( "km/h" ) );
+	m.setRadius( radius );
+	m.setScaleStep( scaleStep );
+	m.setScaleGridStep( 10.0 );
+}
+
+//! Show meter without a window on the screen, so the meter takes real repaint path.
+static void
+showMeter( Meter & m )
+{
+	m.setAttribute( Qt::WA_DontShowOnScreen );
+	m.show();
+}
+
+void
+MeterBenchmark::paint_data()
+{
+	QTest::addColumn< uint >( "radius" );
+	QTest::addColumn< qreal >( "scaleStep" );
+
+	for( const uint radius : { 50u, 100u, 200u, 400u } )
+	{
+		for( const qreal step : { 2.0, 0.5, 0.1 } )
+			QTest::newRow( qPrintable( QStringLiteral( "r%1 step%2" )
+				.arg( radius ).arg( step ) ) ) << radius << step;
+	}
+}
+
+void
+MeterBenchmark::paint()
+{
+	QFETCH( uint, radius );
+	QFETCH( qreal, scaleStep );
+
+	Meter m;
+	setupMeter( m, radius, scaleStep );
+	showMeter( m );
+
+	QImage image( m.size(), QImage::Format_ARGB32_Premultiplied );
+	int i = 0;
+
+	QBENCHMARK {
+		m.setValue( ++i % 220 );
+		m.render( &image );
+	}
+}
+
+void
+MeterBenchmark::setValue_data()
+{
+	QTest::addColumn< int >( "ranges" );
+
+	QTest::newRow( "no ranges" ) << 0;
+	QTest::newRow( "3 ranges" ) << 3;
+}
+
+void
+MeterBenchmark::setValue()
+{
+	QFETCH( int, ranges );
+
+	Meter m;
+	setupMeter( m, 100, 2.0 );
+
+	for( int r = 0; r < ranges; ++r )
+		m.setThresholdRange( 220.0 / ranges * r, 220.0 / ranges * ( r + 1 ), r );
+
+	showMeter( m );
+
+	int i = 0;
+
+	QBENCHMARK {
+		m.setValue( ( ++i * 7 ) % 220 );
+	}
+}
+
+void
+MeterBenchmark::thresholdFired_data()
+{
+	QTest::addColumn< int >( "ranges" );
+
+	for( const int ranges : { 16, 256, 4096 } )
+		QTest::newRow( qPrintable( QString::number( ranges ) ) ) << ranges;
+}
+
+void
+MeterBenchmark::thresholdFired()
+{
+	QFETCH( int, ranges );
+
+	Meter m;
+	setupMeter( m, 100, 2.0 );
+
+	QMultiMap< int, MeterRange > map;
+
+	for( int r = 0; r < ranges; ++r )
+		map.insert( r, { 220.0 / ranges * r, 220.0 / ranges * ( r + 1 ), Qt::transparent } );
+
+	m.setThresholdRanges( map );
+	showMeter( m );
+
+	int i = 0;
+
+	QBENCHMARK {
+		m.setValue( ( ++i * 7919 ) % 220 );
+	}
+}
+
+void
+MeterBenchmark::postValue()
+{
+	Meter m;
+	setupMeter( m, 100, 2.0 );
+	m.setFrameRate( 60 );
+
+	// The first value wakes GUI thread, then GUI thread polls posted values.
+	m.postValue( 1.0 );
+	QCoreApplication::processEvents();
+	QCOMPARE( m.value(), 1.0 );
+
+	int i = 0;
+
+	// Cost of a producer while GUI thread keeps up: store and exchange only.
+	QBENCHMARK {
+		m.postValue( ( ++i * 7 ) % 220 );
+	}
+
+	QTRY_COMPARE( m.value(), qreal( ( i * 7 ) % 220 ) );
+}
+
+void
+MeterBenchmark::renderFace_data()
+{
+	QTest::addColumn< bool >( "drawGridValues" );
+
+	QTest::newRow( "without grid values" ) << false;
+	QTest::newRow( "with grid values" ) << true;
+}
+
+void
+MeterBenchmark::renderFace()
+{
+	QFETCH( bool, drawGridValues );
+
+	MeterSettings s;
+	s.maxValue = 220.0;
+	s.drawGridValues = drawGridValues;
+	s.label = QStringLiteral( "speed" );
+	s.unitsLabel = QStringLiteral( "km/h" );
+
+	const MeterSnapshot snapshot( s, 90.0 );
+
+	// The whole meter is rendered from scratch each time.
+	QBENCHMARK {
+		MeterRenderer::render( snapshot );
+	}
+}
+
+//! Draw labels with QPainter::drawText() as it was before labels were cached.
+static void
+drawLabelsWithText( QPainter & painter, const MeterSettings & s,
+	const MeterRendererPrivate::DrawParams & params )
+{
+	QFont f = s.font;
+	f.setPixelSize( params.fontPixelSize );
+	const QFontMetricsF fm( f );
+
+	painter.save();
+	painter.setFont( f );
+	painter.setPen( s.textColor );
+
+	if( s.scaleGridStep > 0.0 && s.drawGridValues )
+	{
+		painter.save();
+		painter.translate( s.radius, s.radius );
+
+		const qreal startRad = - qDegreesToRadians( (qreal) s.startScaleAngle );
+		const int stepsCount = ( ( s.maxValue - s.minValue ) / s.scaleGridStep );
+		const qreal deltaRad = - qDegreesToRadians( params.scaleDegree / stepsCount );
+		const qreal offset = ( s.radius - params.gridLabelSize - params.margin * 3 );
+
+		for( int i = 0; i <= stepsCount; ++i )
+		{
+			const qreal sina = qSin( startRad + i * deltaRad );
+			const qreal cosa = qCos( startRad + i * deltaRad );
+
+			const QString str = QString::number( s.minValue + i * s.scaleGridStep,
+				'f', s.scalePrecision );
+
+			const QSizeF size = fm.size( Qt::TextSingleLine, str );
+
+			const int x = ( offset * sina ) - ( size.width() / 2 );
+			const int y = ( offset * cosa ) + ( size.height() / 4 );
+
+			painter.drawText( x, y, str );
+		}
+
+		painter.restore();
+	}
+
+	if( !s.unitsLabel.isEmpty() )
+		painter.drawText( QRectF( 0, params.margin * 3 + params.gridLabelSize * 3,
+			s.radius * 2, s.radius ), s.unitsLabel, QTextOption( Qt::AlignHCenter ) );
+
+	if( !s.label.isEmpty() )
+		painter.drawText( QRectF( 0, s.radius * 2 - params.margin * 3 - params.gridLabelSize * 3,
+			s.radius * 2, s.radius ), s.label, QTextOption( Qt::AlignHCenter ) );
+
+	painter.restore();
+}
+
+void
+MeterBenchmark::drawLabels_data()
+{
+	QTest::addColumn< bool >( "cached" );
+
+	QTest::newRow( "drawText" ) << false;
+	QTest::newRow( "QStaticText" ) << true;
+}
+
+void
+MeterBenchmark::drawLabels()
+{
+	QFETCH( bool, cached );
+
+	MeterSettings s;
+	s.maxValue = 220.0;
+	s.radius = 200;
+	s.scaleStep = 2.0;
+	s.label = QStringLiteral( "speed" );
+	s.unitsLabel = QStringLiteral( "km/h" );
+
+	const MeterRendererPrivate::DrawParams params = MeterRendererPrivate::drawParams( s );
+	const MeterRendererPrivate::TickGeometry ticks = MeterRendererPrivate::ticks( s, params );
+	const MeterRendererPrivate::LabelCache labels =
+		MeterRendererPrivate::labels( s, params, ticks );
+
+	QImage image( MeterRenderer::size( s ), QImage::Format_ARGB32_Premultiplied );
+	QPainter p( &image );
+	p.setRenderHint( QPainter::Antialiasing );
+
+	// Cost of labels per frame, layout is done once for cached labels.
+	if( cached )
+	{
+		QBENCHMARK {
+			MeterRendererPrivate::drawLabels( p, s, labels );
+		}
+	}
+	else
+	{
+		QBENCHMARK {
+			drawLabelsWithText( p, s, params );
+		}
+	}
+}
+
+void
+MeterBenchmark::renderBatch_data()
+{
+	QTest::addColumn< int >( "batch" );
+	QTest::addColumn< int >( "threads" );
+
+	const int ideal = QThread::idealThreadCount();
+
+	for( const int batch : { 16, 256 } )
+	{
+		for( const int threads : { 1, ideal } )
+			QTest::newRow( qPrintable( QStringLiteral( "batch%1 threads%2" )
+				.arg( batch ).arg( threads ) ) ) << batch << threads;
+	}
+}
+
+void
+MeterBenchmark::renderBatch()
+{
+	QFETCH( int, batch );
+	QFETCH( int, threads );
+
+	MeterSettings s;
+	s.maxValue = 220.0;
+	s.label = QStringLiteral( "speed" );
+	s.unitsLabel = QStringLiteral( "km/h" );
+
+	QVector< MeterSnapshot > snapshots;
+	snapshots.reserve( batch );
+
+	for( int i = 0; i < batch; ++i )
+		snapshots.append( MeterSnapshot( s, i % 220 ) );
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( threads );
+
+	// Warm up threads of the pool.
+	MeterRenderer::render( snapshots, 1.0, &pool );
+
+	// Throughput is reported in images per second.
+	QElapsedTimer timer;
+	timer.start();
+
+	qint64 images = 0;
+
+	while( timer.elapsed() < 1000 )
+	{
+		QCOMPARE( MeterRenderer::render( snapshots, 1.0, &pool ).size(), batch );
+		images += batch;
+	}
+
+	QTest::setBenchmarkResult( images * 1000000000.0 / timer.nsecsElapsed(),
+		QTest::FramesPerSecond );
+}
+
+#ifdef __GLIBC__
+//! \return Bytes allocated on the heap and not freed yet.
+static qint64
+heapInUse()
+{
+#if __GLIBC_PREREQ( 2, 33 )
+	const struct mallinfo2 info = mallinfo2();
+#else
+	const struct mallinfo info = mallinfo();
+#endif
+
+	return qint64( info.uordblks ) + qint64( info.hblkhd );
+}
+#endif
+
+void
+MeterBenchmark::memoryPerGauge_data()
+{
+	QTest::addColumn< QString >( "host" );
+
+	QTest::newRow( "Meter widget" ) << QStringLiteral( "widget" );
+	QTest::newRow( "MeterPanel record" ) << QStringLiteral( "panel" );
+	QTest::newRow( "sizeof Record" ) << QStringLiteral( "record" );
+}
+
+void
+MeterBenchmark::memoryPerGauge()
+{
+	QFETCH( QString, host );
+
+	static const int c_count = 1000;
+
+	if( host == QStringLiteral( "record" ) )
+	{
+		QTest::setBenchmarkResult( sizeof( MeterPanelPrivate::Record ),
+			QTest::BytesAllocated );
+
+		return;
+	}
+
+#ifdef __GLIBC__
+	MeterStyle style;
+	style.editSettings().maxValue = 220.0;
+	style.editSettings().label = QStringLiteral( "speed" );
+
+	// Heap of the panel itself is not counted, only its records.
+	MeterPanel panel;
+	QWidget parent;
+
+	const qint64 before = heapInUse();
+
+	for( int i = 0; i < c_count; ++i )
+	{
+		if( host == QStringLiteral( "panel" ) )
+			panel.addMeter( style );
+		else
+		{
+			Meter * m = new Meter( &parent );
+			m->setMeterStyle( style );
+		}
+	}
+
+	const qint64 after = heapInUse();
+
+	QTest::setBenchmarkResult( qreal( after - before ) / c_count, QTest::BytesAllocated );
+#else
+	QSKIP( "Heap usage is measured with glibc's mallinfo() only." );
+#endif
+}
+
+void
+MeterBenchmark::bankSetValues_data()
+{
+	QTest::addColumn< int >( "meters" );
+	QTest::addColumn< int >( "ranges" );
+
+	for( const int meters : { 1000, 10000 } )
+	{
+		for( const int ranges : { 0, 3 } )
+			QTest::newRow( qPrintable( QStringLiteral( "%1 meters %2 ranges" )
+				.arg( meters ).arg( ranges ) ) ) << meters << ranges;
+	}
+}
+
+void
+MeterBenchmark::bankSetValues()
+{
+	QFETCH( int, meters );
+	QFETCH( int, ranges );
+
+	MeterStyle style;
+	style.editSettings().maxValue = 220.0;
+
+	for( int r = 0; r < ranges; ++r )
+		style.editSettings().ranges.insert( r,
+			{ 220.0 / ranges * r, 220.0 / ranges * ( r + 1 ), Qt::transparent } );
+
+	MeterBank bank;
+
+	for( int i = 0; i < meters; ++i )
+		bank.addMeter( style );
+
+	// Two frames in turn, so every value changes and some leave their band.
+	QVector< qreal > frames[ 2 ];
+
+	for( int i = 0; i < meters; ++i )
+	{
+		frames[ 0 ].append( ( i * 7 ) % 220 );
+		frames[ 1 ].append( ( i * 7 + 31 ) % 220 );
+	}
+
+	int frame = 0;
+
+	QBENCHMARK {
+		bank.setValues( frames[ frame ].constData(), meters );
+		frame = 1 - frame;
+	}
+}
+
+QTEST_MAIN( MeterBenchmark )
+
+#include "main.moc"
@@ -0,0 +1,209 @@
+
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Widgets include.
+#include <Widgets/Meter>
+
+// Qt include.
+#include <QtTest>
+#include <QThread>
+#include <QtMath>
+
+// C++ include.
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+//
+// Producer
+//
+
+//! Posts values to the meter from its own thread.
+class Producer Q_DECL_FINAL
+	:  public QThread
+{
+public:
+	//! Count of values posted by each producer.
+	static const int c_count = 100000;
+	//! The last value posted by every producer, out of range of others.
+	static constexpr qreal c_lastValue = 99.0;
+
+	Producer( Meter * meter, int seed )
+		:  m_meter( meter )
+		,  m_seed( seed )
+	{
+	}
+
+protected:
+	void run() Q_DECL_OVERRIDE
+	{
+		for( int i = 0; i < c_count; ++i )
+			m_meter->postValue( ( m_seed * 31 + i ) % 90 );
+
+		m_meter->postValue( c_lastValue );
+	}
+
+private:
+	Meter * m_meter;
+	int m_seed;
+}; // class Producer
+
+constexpr qreal Producer::c_lastValue;
+
+
+//
+// WakeCounter
+//
+
+//! Counts events waking GUI thread for posted values of the meter.
+class WakeCounter Q_DECL_FINAL
+	:  public QObject
+{
+public:
+	int count = 0;
+
+protected:
+	bool eventFilter( QObject * watched, QEvent * e ) Q_DECL_OVERRIDE
+	{
+		if( e->type() >= QEvent::User && e->type() <= QEvent::MaxUser )
+			++count;
+
+		return QObject::eventFilter( watched, e );
+	}
+}; // class WakeCounter
+
+
+//
+// PostValueTest
+//
+
+//! Stress test of posting values from several threads, run it under TSan too.
+class PostValueTest Q_DECL_FINAL
+	:  public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void lockFree();
+	void wakesOnlyWhenIdle();
+	void producers();
+}; // class PostValueTest
+
+void
+PostValueTest::lockFree()
+{
+	QVERIFY( std::atomic< qreal > ().is_lock_free() );
+	QVERIFY( std::atomic< bool > ().is_lock_free() );
+}
+
+void
+PostValueTest::wakesOnlyWhenIdle()
+{
+	Meter m;
+	m.setMinValue( 0.0 );
+	m.setMaxValue( 100.0 );
+	m.setFrameRate( 60 );
+
+	WakeCounter wakes;
+	m.installEventFilter( &wakes );
+
+	m.postValue( 10.0 );
+	QCoreApplication::processEvents();
+	QCOMPARE( m.value(), 10.0 );
+	QCOMPARE( wakes.count, 1 );
+
+	// GUI thread polls the slot now, posting doesn't wake it.
+	for( int i = 0; i < 1000; ++i )
+		m.postValue( i % 90 );
+
+	QCOMPARE( wakes.count, 1 );
+	QTRY_COMPARE( m.value(), qreal( 999 % 90 ) );
+	QCOMPARE( wakes.count, 1 );
+
+	// After an idle frame the first posted value wakes GUI thread again.
+	QTest::qWait( 100 );
+
+	m.postValue( 50.0 );
+	QTRY_COMPARE( m.value(), 50.0 );
+	QCOMPARE( wakes.count, 2 );
+}
+
+void
+PostValueTest::producers()
+{
+	Meter m;
+	m.setMinValue( 0.0 );
+	m.setMaxValue( 100.0 );
+	m.setAttribute( Qt::WA_DontShowOnScreen );
+	m.show();
+
+	// Only posted values are applied, each applied value is one of them.
+	bool foreign = false;
+
+	connect( &m, &Meter::valueChanged,
+		[&foreign] ( qreal v )
+		{
+			if( v != Producer::c_lastValue && ( v < 0.0 || v >= 90.0 || v != qFloor( v ) ) )
+				foreign = true;
+		} );
+
+	WakeCounter wakes;
+	m.installEventFilter( &wakes );
+
+	const int count = qMax( 4, QThread::idealThreadCount() );
+
+	std::vector< std::unique_ptr< Producer > > producers;
+
+	for( int i = 0; i < count; ++i )
+	{
+		producers.emplace_back( new Producer( &m, i ) );
+		producers.back()->start();
+	}
+
+	// GUI loop spins and applies posted values while producers run.
+	for( const auto & p : producers )
+	{
+		while( !p->isFinished() )
+			QCoreApplication::processEvents();
+
+		p->wait();
+	}
+
+	QTRY_COMPARE( m.value(), Producer::c_lastValue );
+	QVERIFY( !foreign );
+	// Producers wake GUI thread only after idle frames, not per value.
+	QVERIFY( wakes.count < count * Producer::c_count / 100 );
+}
+
+QTEST_MAIN( PostValueTest )
+
+#include "main.moc"
@@ -0,0 +1,198 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Widgets include.
+#include <Widgets/Meter>
+
+// Qt include.
+#include <QtTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+
+
+//
+// ThresholdsTest
+//
+
+//! Checks when thresholds fire: on entry, with hysteresis and with dwell time.
+class ThresholdsTest Q_DECL_FINAL
+	:  public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void firesOnBandEntry();
+	void hysteresis();
+	void dwellTime();
+	void dwellOnTimestamps();
+}; // class ThresholdsTest
+
+//! Meter with thresholds 1, 2 and 3 on [10, 30), [30, 60) and [60, 100).
+static void
+setupMeter( Meter & m )
+{
+	m.setMinValue( 0.0 );
+	m.setMaxValue( 100.0 );
+	m.setThresholdRange( 10.0, 30.0, 1 );
+	m.setThresholdRange( 30.0, 60.0, 2 );
+	m.setThresholdRange( 60.0, 100.0, 3 );
+}
+
+//! \return Threshold index of the last signal.
+static int
+lastThreshold( const QSignalSpy & spy )
+{
+	return spy.last().at( 0 ).toInt();
+}
+
+void
+ThresholdsTest::firesOnBandEntry()
+{
+	Meter m;
+	setupMeter( m );
+
+	QSignalSpy spy( &m, &Meter::thresholdFired );
+
+	m.setValue( 5.0 );
+	QCOMPARE( spy.count(), 0 );
+
+	m.setValue( 15.0 );
+	QCOMPARE( spy.count(), 1 );
+	QCOMPARE( lastThreshold( spy ), 1 );
+
+	// Values inside the current band don't fire.
+	m.setValue( 20.0 );
+	m.setValue( 29.0 );
+	QCOMPARE( spy.count(), 1 );
+
+	m.setValue( 40.0 );
+	QCOMPARE( spy.count(), 2 );
+	QCOMPARE( lastThreshold( spy ), 2 );
+
+	m.setValue( 70.0 );
+	QCOMPARE( spy.count(), 3 );
+	QCOMPARE( lastThreshold( spy ), 3 );
+
+	// Leaving all ranges doesn't fire, entering the same threshold again doesn't too.
+	m.setValue( 5.0 );
+	m.setValue( 80.0 );
+	QCOMPARE( spy.count(), 3 );
+
+	m.setValue( 15.0 );
+	QCOMPARE( spy.count(), 4 );
+	QCOMPARE( lastThreshold( spy ), 1 );
+}
+
+void
+ThresholdsTest::hysteresis()
+{
+	Meter m;
+	setupMeter( m );
+	m.setThresholdHysteresis( 5.0 );
+
+	QSignalSpy spy( &m, &Meter::thresholdFired );
+
+	m.setValue( 20.0 );
+	QCOMPARE( spy.count(), 1 );
+	QCOMPARE( lastThreshold( spy ), 1 );
+
+	// Inside the margin above the current range.
+	m.setValue( 32.0 );
+	m.setValue( 34.9 );
+	QCOMPARE( spy.count(), 1 );
+
+	m.setValue( 36.0 );
+	QCOMPARE( spy.count(), 2 );
+	QCOMPARE( lastThreshold( spy ), 2 );
+
+	// Inside the margin below the current range.
+	m.setValue( 27.0 );
+	m.setValue( 25.1 );
+	QCOMPARE( spy.count(), 2 );
+
+	m.setValue( 24.0 );
+	QCOMPARE( spy.count(), 3 );
+	QCOMPARE( lastThreshold( spy ), 1 );
+}
+
+void
+ThresholdsTest::dwellTime()
+{
+	Meter m;
+	setupMeter( m );
+	m.setThresholdDwellTime( 200 );
+
+	QSignalSpy spy( &m, &Meter::thresholdFired );
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// The first threshold fires right away, there is nothing to dwell in.
+	m.setValue( 20.0 );
+	QCOMPARE( spy.count(), 1 );
+
+	// The next one waits till the current one was kept for dwell time.
+	m.setValue( 40.0 );
+	QCOMPARE( spy.count(), 1 );
+
+	QTRY_COMPARE( spy.count(), 2 );
+	QCOMPARE( lastThreshold( spy ), 2 );
+	QVERIFY( timer.elapsed() >= 190 );
+
+	// After dwell time is over a new threshold fires at once.
+	QTest::qWait( 250 );
+
+	m.setValue( 70.0 );
+	QCOMPARE( spy.count(), 3 );
+	QCOMPARE( lastThreshold( spy ), 3 );
+}
+
+void
+ThresholdsTest::dwellOnTimestamps()
+{
+	Meter m;
+	setupMeter( m );
+	m.setThresholdDwellTime( 200 );
+
+	// Dwell time is measured between timestamps of the batch.
+	const QVector< MeterCrossing > crossings = m.setValues(
+		{ 20.0, 40.0, 41.0 }, { 1000, 1100, 1300 } );
+
+	QCOMPARE( crossings.size(), 2 );
+	QCOMPARE( crossings.at( 0 ).sampleIndex, 0 );
+	QCOMPARE( crossings.at( 0 ).thresholdIndex, 1 );
+	QCOMPARE( crossings.at( 1 ).sampleIndex, 2 );
+	QCOMPARE( crossings.at( 1 ).timestamp, qint64( 1300 ) );
+	QCOMPARE( crossings.at( 1 ).thresholdIndex, 2 );
+}
+
+QTEST_MAIN( ThresholdsTest )
+
+#include "main.moc"
@@ -0,0 +1,198 @@
+
+/*!
+	\file
+
+	\author Igor Mironchik (igor.mironchik at gmail dot com).
+
+	Copyright (c) 2020 Igor Mironchik
+
+	Permission is hereby granted, free of charge, to any person
+	obtaining a copy of this software and associated documentation
+	files (the "Software"), to deal in the Software without
+	restriction, including without limitation the rights to use,
+	copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the
+	Software is furnished to do so, subject to the following
+	conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+	OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+	NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+	HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+	WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+	OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Widgets include.
+#include <Widgets/Meter>
+#include <Widgets/MeterValueStats>
+
+// Qt include.
+#include <QtTest>
+#include <QtMath>
+
+
+//
+// ValueStatsTest
+//
+
+//! Checks statistics of values against known data.
+class ValueStatsTest Q_DECL_FINAL
+	:  public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void meanAndVariance();
+	void decayedMean();
+	void window();
+	void quantilesOfFewValues();
+	void quantiles_data();
+	void quantiles();
+	void meterStats();
+}; // class ValueStatsTest
+
+void
+ValueStatsTest::meanAndVariance()
+{
+	MeterValueStats s;
+
+	for( int i = 1; i <= 100; ++i )
+		s.add( i );
+
+	QCOMPARE( s.count(), qint64( 100 ) );
+	QCOMPARE( s.mean(), 50.5 );
+	// Population variance of 1..n is ( n * n - 1 ) / 12.
+	QVERIFY( qAbs( s.variance() - 833.25 ) < 1e-9 );
+}
+
+void
+ValueStatsTest::decayedMean()
+{
+	const int halfLife = 5;
+	const qreal decay = qPow( 0.5, 1.0 / halfLife );
+
+	MeterValueStats s;
+	s.setHalfLife( halfLife );
+
+	qreal sum = 0.0;
+	qreal weight = 0.0;
+
+	// Reference is the exponentially weighted mean computed directly.
+	for( int i = 0; i < 200; ++i )
+	{
+		const qreal v = ( i * 37 ) % 101;
+
+		s.add( v );
+
+		sum = sum * decay + v;
+		weight = weight * decay + 1.0;
+
+		QVERIFY( qAbs( s.mean() - sum / weight ) < 1e-9 );
+	}
+
+	// A step is followed half-way after half-life samples.
+	MeterValueStats step;
+	step.setHalfLife( halfLife );
+
+	for( int i = 0; i < 1000; ++i )
+		step.add( 0.0 );
+
+	for( int i = 0; i < halfLife; ++i )
+		step.add( 100.0 );
+
+	QVERIFY( qAbs( step.mean() - 50.0 ) < 1e-6 );
+}
+
+void
+ValueStatsTest::window()
+{
+	MeterValueStats s;
+	s.setWindow( 10 );
+
+	for( int i = 0; i < 15; ++i )
+		s.add( i );
+
+	QCOMPARE( s.count(), qint64( 5 ) );
+	QCOMPARE( s.mean(), 12.0 );
+}
+
+void
+ValueStatsTest::quantilesOfFewValues()
+{
+	MeterValueStats s;
+
+	QCOMPARE( s.p95(), 0.0 );
+
+	s.add( 3.0 );
+	s.add( 1.0 );
+	s.add( 2.0 );
+
+	QCOMPARE( s.p95(), 3.0 );
+	QCOMPARE( s.p99(), 3.0 );
+}
+
+void
+ValueStatsTest::quantiles_data()
+{
+	QTest::addColumn< int >( "count" );
+
+	QTest::newRow( "1000" ) << 1000;
+	QTest::newRow( "100000" ) << 100000;
+}
+
+void
+ValueStatsTest::quantiles()
+{
+	QFETCH( int, count );
+
+	MeterValueStats s;
+
+	// Each of 0 .. count - 1 exactly once in scrambled order.
+	for( int i = 0; i < count; ++i )
+		s.add( ( qint64( i ) * 7919 ) % count );
+
+	const qreal tolerance = count * 0.01;
+
+	QVERIFY2( qAbs( s.p95() - count * 0.95 ) < tolerance, qPrintable( QString::number( s.p95() ) ) );
+	QVERIFY2( qAbs( s.p99() - count * 0.99 ) < tolerance, qPrintable( QString::number( s.p99() ) ) );
+}
+
+void
+ValueStatsTest::meterStats()
+{
+	Meter m;
+	m.setMinValue( 0.0 );
+	m.setMaxValue( 100.0 );
+	m.setValueStatsHalfLife( 10 );
+	m.setValueStatsWindow( 50 );
+
+	// Nothing is collected while statistics are off.
+	m.setValue( 10.0 );
+	QCOMPARE( m.valueStats().count(), qint64( 0 ) );
+
+	m.setValueStatsEnabled();
+	QCOMPARE( m.valueStats().halfLife(), 10 );
+	QCOMPARE( m.valueStats().window(), 50 );
+
+	m.setValue( 20.0 );
+	m.setValue( 30.0 );
+	QCOMPARE( m.valueStats().count(), qint64( 2 ) );
+
+	m.resetValueStats();
+	QCOMPARE( m.valueStats().count(), qint64( 0 ) );
+
+	m.setValue( 40.0 );
+	m.setValueStatsEnabled( false );
+	QCOMPARE( m.valueStats().count(), qint64( 0 ) );
+	QCOMPARE( m.valueStatsHalfLife(), 10 );
+}
+
+QTEST_MAIN( ValueStatsTest )
+
+#include "main.moc"